@@ -0,0 +1,58 @@
+#version 330 core
+// os_benchmark stand-in body: Phong over the diffuse/specular maps, lights from the Frame block,
+// sun shadow map opted in (see ShadowMap)
+struct Material
+{
+    sampler2D diffuse;
+    sampler2D specular;
+    float shininess;
+};
+
+struct Light
+{
+    vec4 r_Go2Lo_gl;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+
+layout (std140) uniform Frame
+{
+    mat4 view;
+    vec4 r_Go2Vo_gl;
+    Light sun;
+    Light moon;
+};
+
+uniform Material material;
+
+uniform sampler2DShadow sunShadow;
+uniform mat4 sunShadowMatrix;
+uniform int sunShadowOn;
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+// a light that is off is all zeros and adds nothing; lit scales the diffuse and specular terms
+vec3 Phong(Light light, float lit, vec3 n, vec3 v, vec3 base, vec3 specularColor)
+{
+    if (dot(light.r_Go2Lo_gl.xyz, light.r_Go2Lo_gl.xyz) == 0.0)
+        return vec3(0.0);
+    vec3 l = normalize(light.r_Go2Lo_gl.xyz);
+    float diffuse = max(dot(n, l), 0.0);
+    float specular = pow(max(dot(v, reflect(-l, n)), 0.0), material.shininess);
+    return (light.ambient.rgb + lit * light.diffuse.rgb * diffuse) * base + lit * light.specular.rgb * specular * specularColor;
+}
+
+void main()
+{
+    vec3 n = normalize(Normal);
+    vec3 v = normalize(r_Go2Vo_gl.xyz - FragPos);
+    vec3 base = texture(material.diffuse, TexCoords).rgb;
+    vec3 specularColor = texture(material.specular, TexCoords).rgb;
+    float lit = (sunShadowOn != 0) ? texture(sunShadow, (sunShadowMatrix * vec4(FragPos, 1.0)).xyz) : 1.0;
+    FragColor = vec4(Phong(sun, lit, n, v, base, specularColor) + Phong(moon, 1.0, n, v, base, specularColor), 1.0);
+}
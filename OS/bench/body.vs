@@ -0,0 +1,36 @@
+#version 330 core
+// os_benchmark stand-in body: Phong over the diffuse/specular maps, lights from the Frame block
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+struct Light
+{
+    vec4 r_Go2Lo_gl;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+
+layout (std140) uniform Frame
+{
+    mat4 view;
+    vec4 r_Go2Vo_gl;
+    Light sun;
+    Light moon;
+};
+
+uniform mat4 model;
+uniform mat4 projection;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+void main()
+{
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    TexCoords = aTexCoords;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
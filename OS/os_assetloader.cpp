@@ -0,0 +1,391 @@
+// OS_ASSETLOADER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: loads CAD assemblies and their textures in parallel; CSV/STL
+//              parsing, vertex building and image decoding run on worker
+//              threads, the GL thread only uploads the finished buffers
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_assetloader.hpp"
+#include "os_softraster.hpp"
+#include "os_sphere.hpp"
+
+#include "include/stb/stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+void DecodeTexture(const std::string& path, TextureImage& image){
+
+    image.path = path;
+    image.data = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+}
+
+GLuint UploadTexture(TextureImage& image){
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    if (image.data)
+    {
+        GLenum format = GL_RGB;
+        if (image.channels == 1)
+            format = GL_RED;
+        else if (image.channels == 3)
+            format = GL_RGB;
+        else if (image.channels == 4)
+            format = GL_RGBA;
+
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        stbi_image_free(image.data);
+        image.data = NULL;
+    }
+    else
+    {
+        std::cout << "Texture failed to load at path: " << image.path << std::endl;
+    }
+
+    return textureID;
+}
+
+// software renderer: the decoded pixels are kept on the CPU instead
+static void KeepTexture(TextureImage& image, SoftTexture& texture){
+
+    if (image.data == NULL){
+        std::cout << "Texture failed to load at path: " << image.path << std::endl;
+        return;
+    }
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.channels = image.channels;
+    texture.pixels.assign(image.data, image.data + (size_t) image.width * image.height * image.channels);
+    stbi_image_free(image.data);
+    image.data = NULL;
+}
+
+void ParallelFor(int n, int nThreads, const std::function<void(int)>& fn){
+
+    if (nThreads > n)
+        nThreads = n;
+
+    // threads pull the next index, so uneven items (large STL parts) balance themselves
+    std::atomic<int> next(0);
+    auto work = [&](){
+        for (int i = next++; i < n; i = next++)
+            fn(i);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nThreads; t++)
+        threads.push_back(std::thread(work));
+    work();
+    for (auto& t : threads)
+        t.join();
+}
+
+AssetLoader::AssetLoader(GL& gl) :
+    m_gl(gl),
+    m_quantizeNormals(gl.m_quantizeNormals),
+    m_meshCache(gl.m_meshCache),
+    m_lodLevels(gl.m_lodLevels)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    // textures of a failed Load were never uploaded
+    for (auto& asset : m_assets){
+        stbi_image_free(asset->diffuse.data);
+        stbi_image_free(asset->specular.data);
+    }
+}
+
+int AssetLoader::AddCAD(const std::string& root_dir, const std::string& fn_csv,
+                        const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale){
+    return Add(false, root_dir, fn_csv, fn_textureDiffuse, fn_textureSpecular, scale);
+}
+
+int AssetLoader::AddTexturedSphere(const std::string& root_dir, const std::string& fn_csv,
+                                   const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale){
+    return Add(true, root_dir, fn_csv, fn_textureDiffuse, fn_textureSpecular, scale);
+}
+
+int AssetLoader::AddProceduralSphere(int level, float radius,
+                                     const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale){
+    int index = Add(true, "", "", fn_textureDiffuse, fn_textureSpecular, scale);
+    m_assets[index]->procedural = true;
+    m_assets[index]->level = level;
+    m_assets[index]->radius = radius;
+    return index;
+}
+
+int AssetLoader::Add(bool textured, const std::string& root_dir, const std::string& fn_csv,
+                     const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale){
+
+    std::unique_ptr<Asset> asset(new Asset());
+    asset->textured = textured;
+    asset->procedural = false;
+    asset->level = 0;
+    asset->radius = 0.0f;
+    asset->root_dir = root_dir;
+    asset->fn_csv = fn_csv;
+    asset->scale = scale;
+    asset->cached = false;
+    asset->parsed = false;
+    asset->diffuse = {fn_textureDiffuse, 0, 0, 0, NULL};
+    asset->specular = {fn_textureSpecular, 0, 0, 0, NULL};
+    if (textured)
+        asset->format = MeshCache::FORMAT_TEXTURED;
+    else
+        asset->format = m_quantizeNormals ? MeshCache::FORMAT_CAD_QUANTIZED : MeshCache::FORMAT_CAD;
+
+    m_assets.push_back(std::move(asset));
+    return (int) m_assets.size() - 1;
+}
+
+std::vector<CAD> AssetLoader::Load(int nThreads){
+
+    if (nThreads <= 0)
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // 1) per asset: cache lookup or CSV/STL parse, and both texture decodes
+    int nAssets = (int) m_assets.size();
+    ParallelFor(3*nAssets, nThreads, [this](int i){
+        Asset& asset = *m_assets[i / 3];
+        if (i % 3 == 0)
+            Prepare(asset);
+        else if (i % 3 == 1)
+            DecodeTexture(asset.diffuse.path, asset.diffuse);
+        else
+            DecodeTexture(asset.specular.path, asset.specular);
+    });
+
+    for (auto& asset : m_assets){
+        if (!asset->cached && !asset->parsed){
+            std::cout << "Error parsing CSV: "<< std::string( asset->root_dir + asset->fn_csv ) << std::endl;
+            throw std::runtime_error("Could not read CSV\n");
+        }
+    }
+
+    // 2) vertex data of every part of every parsed asset
+    std::vector< std::pair<int, size_t> > parts;
+    for (int a = 0; a < nAssets; a++){
+        Asset& asset = *m_assets[a];
+        if (asset.cached || asset.procedural)
+            continue;
+        const auto& assemblyParts = asset.cad.assembly.parts;
+        size_t nParts = assemblyParts.size();
+        if (asset.textured){
+            // 3 vertices per triangle
+            GLint total_vertices = 0;
+            for (const auto& part : assemblyParts){
+                asset.first.push_back(total_vertices);
+                asset.count.push_back(3*part.triangles.size());
+                total_vertices += asset.count.back();
+            }
+            asset.staging.resize((size_t) 8*total_vertices);
+        }
+        else
+            asset.partBuilders.assign(nParts, MeshBuilder(m_quantizeNormals));
+        for (size_t k = 0; k < nParts; k++)
+            parts.push_back(std::make_pair(a, k));
+    }
+    ParallelFor((int) parts.size(), nThreads, [this, &parts](int i){
+        BuildPart(*m_assets[parts[i].first], parts[i].second);
+    });
+
+    // 3) per asset: final vertex/index arrays and the LOD chain
+    ParallelFor(nAssets, nThreads, [this](int i){
+        Finish(*m_assets[i]);
+    });
+
+    // 4) GL thread: uploads only
+    std::vector<CAD> cads;
+    for (auto& asset : m_assets){
+        Upload(*asset);
+        cads.push_back(asset->cad);
+    }
+    return cads;
+}
+
+void AssetLoader::Prepare(Asset& asset){
+
+    if (asset.procedural){
+        BuildSphere(asset.level, asset.radius, asset.staging, asset.stagingIndices);
+        asset.first.assign(1, 0);
+        asset.count.assign(1, (GLsizei) asset.stagingIndices.size());
+        asset.parsed = true;
+        return;
+    }
+
+    // preprocessed mesh from a previous run, valid while the CSV and STL files are unchanged
+    if (m_meshCache){
+        asset.sources = MeshCache::Sources(asset.root_dir, asset.fn_csv);
+        std::string fn_cache = asset.root_dir + asset.fn_csv + ".osmc";
+        asset.cached = MeshCache::Open(fn_cache, asset.sources, asset.format, asset.mapped);
+        if (asset.cached)
+            return;
+    }
+
+    try {
+        asset.cad.assembly = cad::parse(asset.fn_csv, asset.root_dir);
+        asset.parsed = true;
+    }catch (...){
+        asset.parsed = false;
+    }
+}
+
+void AssetLoader::BuildPart(Asset& asset, size_t k){
+
+    const auto& part = asset.cad.assembly.parts[k];
+
+    if (!asset.textured){
+        // color is constant per part, shared vertices are welded by the builder
+        MeshBuilder& builder = asset.partBuilders[k];
+        builder.Reserve(3*part.triangles.size());
+        m_gl.LoadSTL(part, builder);
+        return;
+    }
+
+    // 8 attributes per vertex (xyz,normal,uv), written straight into this part's range
+    float* vertices = asset.staging.data() + (size_t) 8*asset.first[k];
+    int N = asset.count[k];
+
+    // per-thread scratch for the UV kernel, reused across parts
+    static thread_local std::vector<float> x, y, z, u, v;
+    x.resize(N); y.resize(N); z.resize(N); u.resize(N); v.resize(N);
+
+    float mm2m = 1.0f/1000.0f;  // convert STL from [mm] to [m]
+    float epsilon = 1e-1;       // avoid singularity
+    int i = 0;
+    for (const auto& t : part.triangles){
+        for (const auto* p : {&t.v1, &t.v2, &t.v3}){
+            x[i] = (float) (p->x + epsilon);
+            y[i] = (float) (p->y + epsilon);
+            z[i] = (float) (p->z + epsilon);
+            float* dst = vertices + 8*i;
+            dst[0] = x[i] * mm2m;
+            dst[1] = y[i] * mm2m;
+            dst[2] = z[i] * mm2m;
+            dst[3] = (float) t.normal.x;
+            dst[4] = (float) t.normal.y;
+            dst[5] = (float) t.normal.z;
+            i++;
+        }
+    }
+
+    // equirectangular texture coordinates, SIMD over the whole part
+    SphereUV(x.data(), y.data(), z.data(), N, u.data(), v.data());
+    for (i = 0; i < N; i++){
+        vertices[8*i + 6] = u[i];
+        vertices[8*i + 7] = v[i];
+    }
+}
+
+void AssetLoader::Finish(Asset& asset){
+
+    if (asset.cached){
+        const MeshCache::Mapped& mapped = asset.mapped;
+        asset.vertices = mapped.vertices;
+        asset.vertexBytes = mapped.vertexBytes;
+        asset.stride = mapped.stride;
+        asset.attributes = mapped.attributes;
+        asset.indices = mapped.indices;
+        asset.nIndices = mapped.nIndices;
+        asset.first = mapped.first;
+        asset.count = mapped.count;
+    }
+    else if (!asset.textured){
+        // pack every part into one indexed buffer, remembering where each part starts
+        asset.merged.reset(new MeshBuilder(m_quantizeNormals));
+        MeshBuilder& builder = *asset.merged;
+        size_t total_vertices = 0;
+        for (const auto& part : asset.partBuilders)
+            total_vertices += part.m_indices.size();
+        builder.Reserve(total_vertices);
+        for (const auto& part : asset.partBuilders)
+            builder.Append(part);
+        asset.partBuilders.clear();
+
+        // format [position, normals, rgb]
+        asset.vertices = builder.m_vertices.data();
+        asset.vertexBytes = builder.m_vertices.size();
+        asset.stride = builder.Stride();
+        asset.attributes = builder.Attributes();
+        asset.indices = builder.m_indices.data();
+        asset.nIndices = builder.m_indices.size();
+        asset.first = builder.m_first;
+        asset.count = builder.m_count;
+    }
+    else{
+        // format [position, normals, uv]
+        asset.vertices = asset.staging.data();
+        asset.vertexBytes = sizeof(float)*asset.staging.size();
+        asset.stride = 8*sizeof(float);
+        asset.attributes = Mesh::FloatAttributes({3, 3, 2});
+        asset.indices = asset.stagingIndices.empty() ? NULL : asset.stagingIndices.data();
+        asset.nIndices = asset.stagingIndices.size();
+    }
+
+    // decimated copies for far range (GL meshes only)
+    if (!m_gl.m_software)
+        asset.cad.lod.Build(asset.vertices, asset.vertexBytes, asset.stride, asset.attributes,
+                            asset.indices, asset.nIndices, asset.first, asset.count, m_lodLevels);
+}
+
+void AssetLoader::Upload(Asset& asset){
+
+    CAD& foo = asset.cad;
+    foo.r_vbs = Vector(3);
+    foo.q_vbs2body = Vector(4);
+    foo.q_vbs2body(0) = 1;
+    foo.scale = asset.scale;
+    foo.initialized = true;
+
+    const float* bounds = asset.cached ? asset.mapped.bounds.data() : NULL;
+    if (m_gl.m_software){
+        // unpacked CPU copy for the rasterizer, the part table and bounds still feed ROI and keypoints
+        foo.soft = std::make_shared<SoftMesh>();
+        foo.soft->Build(asset.vertices, asset.vertexBytes, asset.stride, asset.attributes,
+                        asset.indices, asset.nIndices, asset.first, asset.count);
+        KeepTexture(asset.diffuse, foo.soft->diffuse);
+        KeepTexture(asset.specular, foo.soft->specular);
+        foo.mesh.SetParts(asset.vertices, asset.stride, asset.indices, asset.nIndices, asset.first, asset.count, bounds);
+    }
+    else{
+        foo.texture.diffuse = UploadTexture(asset.diffuse);
+        foo.texture.specular = UploadTexture(asset.specular);
+        foo.mesh.UploadRaw(asset.vertices, asset.vertexBytes, asset.stride, asset.attributes,
+                           asset.indices, asset.nIndices, asset.first, asset.count, bounds);
+        foo.lod.Upload();
+    }
+
+    if (m_meshCache && !asset.cached && !asset.procedural){
+        std::string fn_cache = asset.root_dir + asset.fn_csv + ".osmc";
+        MeshCache::Save(fn_cache, asset.sources, asset.format, foo.mesh, asset.attributes,
+                        asset.vertices, asset.vertexBytes, asset.indices, asset.nIndices);
+    }
+
+    // release the CPU copies now rather than with the loader
+    asset.mapped.file.Close();
+    asset.merged.reset();
+    std::vector<float>().swap(asset.staging);
+    std::vector<GLuint>().swap(asset.stagingIndices);
+}
@@ -0,0 +1,125 @@
+// OS_ASSETLOADER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: loads CAD assemblies and their textures in parallel; CSV/STL
+//              parsing, vertex building and image decoding run on worker
+//              threads, the GL thread only uploads the finished buffers
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_ASSETLOADER_HPP
+#define OS_ASSETLOADER_HPP
+
+#include "os_gl.hpp"
+#include "os_lod.hpp"
+#include "os_mesh.hpp"
+#include "os_meshcache.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// decoded image waiting for upload
+struct TextureImage
+{
+    std::string path;
+    int width;
+    int height;
+    int channels;
+    unsigned char* data;        // stb_image allocation, NULL if decoding failed
+};
+
+// any thread
+void DecodeTexture(const std::string& path, TextureImage& image);
+
+// GL thread; frees the pixels, returns a texture name even if decoding failed (as before)
+GLuint UploadTexture(TextureImage& image);
+
+// runs fn(0) ... fn(n-1) on nThreads threads, the caller included
+void ParallelFor(int n, int nThreads, const std::function<void(int)>& fn);
+
+class AssetLoader
+{
+public:
+    // takes the vertex format and cache settings from gl
+    AssetLoader(GL& gl);
+    ~AssetLoader();
+
+    // queue an asset, returns its index into the result of Load
+    int AddCAD(const std::string& root_dir, const std::string& fn_csv,
+               const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale);
+    int AddTexturedSphere(const std::string& root_dir, const std::string& fn_csv,
+                          const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale);
+
+    // textured sphere generated at a tessellation level instead of read from STL (see BuildSphere)
+    // radius in model units [m], before 'scale'
+    int AddProceduralSphere(int level, float radius,
+                            const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale);
+
+    // call on the GL thread; nThreads <= 0 uses every core
+    // throws std::runtime_error if any CSV cannot be parsed (nothing is uploaded then)
+    std::vector<CAD> Load(int nThreads);
+
+private:
+    struct Asset
+    {
+        bool textured;                  // LoadTexturedSphere layout
+        bool procedural;                // generated, no CSV/STL
+        int level;
+        float radius;
+        std::string root_dir;
+        std::string fn_csv;
+        float scale;
+
+        std::vector<std::string> sources;
+        uint32_t format;
+        bool cached;
+        MeshCache::Mapped mapped;
+        bool parsed;
+
+        CAD cad;
+        TextureImage diffuse;
+        TextureImage specular;
+
+        std::vector<MeshBuilder> partBuilders;          // CAD
+
+        // textured sphere: one size-exact staging buffer, every part fills its own range
+        std::vector<float> staging;
+        std::vector<GLuint> stagingIndices;             // procedural only
+        std::vector<GLint> first;
+        std::vector<GLsizei> count;
+
+        // what gets uploaded, set by Finish (points into mapped, merged or staging)
+        std::unique_ptr<MeshBuilder> merged;
+        const void* vertices;
+        size_t vertexBytes;
+        GLsizei stride;
+        std::vector<VertexAttribute> attributes;
+        const GLuint* indices;
+        size_t nIndices;
+    };
+
+    int Add(bool textured, const std::string& root_dir, const std::string& fn_csv,
+            const std::string& fn_textureDiffuse, const std::string& fn_textureSpecular, float scale);
+
+    // worker stages
+    void Prepare(Asset& asset);
+    void BuildPart(Asset& asset, size_t k);
+    void Finish(Asset& asset);
+
+    // GL stage
+    void Upload(Asset& asset);
+
+    GL& m_gl;
+    bool m_quantizeNormals;
+    bool m_meshCache;
+    int m_lodLevels;
+    std::vector< std::unique_ptr<Asset> > m_assets;
+};
+
+#endif
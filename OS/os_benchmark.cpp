@@ -0,0 +1,639 @@
+// OS_BENCHMARK.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: stand-alone timing harness for the OS pipeline
+//              usage: os_benchmark [section ...]   (no argument = all)
+//
+//   runs on Mesa software rendering (llvmpipe) unless OS_BENCH_HARDWARE
+//   is set, inputs come from BENCH_SEED or the checked-in bench/ scene and pose sets
+//   OS_BENCH_SCENE   scene file (see SceneConfig) for render / starfield
+//                    (default bench/scene_bench.cfg, a procedural stand-in body)
+//   OS_BENCH_POSES   pose table for render / tiling (default bench/poses_tango.csv)
+//   OS_BENCH_TMP     scratch directory for encode (default .)
+//   OS_BENCH_JSON    also write every result to this file
+//   OS_RENDERER      "software": the CPU rasterizer instead of any GL driver
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_assetloader.hpp"
+#include "os_gl.hpp"
+#include "os_meshcache.hpp"
+#include "os_opticalstimulator.hpp"
+#include "os_posetable.hpp"
+#include "os_projection.hpp"
+#include "os_scene.hpp"
+#include "os_skyindex.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// fixed seed so every run sees the same inputs
+static const unsigned int BENCH_SEED = 20180130;
+
+static double Seconds(chrono::steady_clock::time_point t0){
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// OS_RENDERER=software: the CPU rasterizer, no GL context at all
+// checked-in inputs, relative to OS/ (run from there)
+static const char* DEFAULT_SCENE = "bench/scene_bench.cfg";
+static const char* DEFAULT_POSES = "bench/poses_tango.csv";
+
+static bool SoftwareRenderer(){
+    const char* renderer = getenv("OS_RENDERER");
+    return renderer != NULL && string(renderer) == "software";
+}
+
+// GPU work of the timed calls done before the clock stops (the software renderer is synchronous)
+static void Finish(GL& gl){
+    if (!gl.m_software)
+        glFinish();
+}
+
+// every number printed in the tables, for OS_BENCH_JSON
+struct Result { string section, name, unit; double value; };
+static vector<Result> g_results;
+
+static void Record(const char* section, const string& name, double value, const char* unit){
+    g_results.push_back(Result{section, name, unit, value});
+}
+
+static void WriteResults(const char* path){
+    FILE* f = fopen(path, "w");
+    if (f == NULL){
+        printf("cannot write %s\n", path);
+        return;
+    }
+    fprintf(f, "[");
+    for(size_t i=0; i<g_results.size(); i++)
+        fprintf(f, "%s\n  {\"section\": \"%s\", \"name\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}",
+                i == 0 ? "" : ",", g_results[i].section.c_str(), g_results[i].name.c_str(),
+                g_results[i].value, g_results[i].unit.c_str());
+    fprintf(f, "\n]\n");
+    fclose(f);
+}
+
+// nearest-rank percentile, sorts 'samples'
+static double Percentile(vector<double>& samples, double p){
+    if (samples.empty())
+        return 0.0;
+    sort(samples.begin(), samples.end());
+    size_t rank = (size_t) ceil(p * samples.size());
+    return samples[min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+static Matrix Identity3(){
+    Matrix R(3,3);
+    for(int i=0; i<3; i++)
+        for(int j=0; j<3; j++)
+            R(i,j) = (i == j) ? 1.0 : 0.0;
+    return R;
+}
+
+// ------------------------------------------------------------------------
+// star catalog cone queries: Hipparcos::StarsInFOV scan vs SkyIndex
+// ------------------------------------------------------------------------
+static void BenchStarQuery(){
+
+    const double halfFOV_deg = 10.0;
+    const int N_QUERIES = 2000;
+    const double magThresh[] = {5.0, 6.0, 7.0, 8.0, 9.0};
+
+    // slow attitude sweep: boresight moves 0.05 deg per frame around a random great circle
+    mt19937 rng(BENCH_SEED);
+    normal_distribution<double> gauss;
+    vector<Vector> boresight;
+    double a[3], b[3];
+    for(int k=0; k<3; k++){ a[k] = gauss(rng); b[k] = gauss(rng); }
+    double na = sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+    for(int k=0; k<3; k++) a[k] /= na;
+    double ab = a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    for(int k=0; k<3; k++) b[k] -= ab*a[k];
+    double nb = sqrt(b[0]*b[0] + b[1]*b[1] + b[2]*b[2]);
+    for(int k=0; k<3; k++) b[k] /= nb;
+    for(int i=0; i<N_QUERIES; i++){
+        double t = i * 0.05 * DEG2RAD;
+        boresight.push_back(Vector(cos(t)*a[0] + sin(t)*b[0],
+                                   cos(t)*a[1] + sin(t)*b[1],
+                                   cos(t)*a[2] + sin(t)*b[2]));
+    }
+
+    printf("\n[stars] cone queries, halfFOV = %.1f deg, %d queries\n", halfFOV_deg, N_QUERIES);
+    printf("%10s %10s %14s %14s %10s\n", "magThresh", "catalog", "scan [us]", "index [us]", "speedup");
+
+    for(double mag : magThresh){
+        Hipparcos hsc(mag, halfFOV_deg);
+
+        vector<SO> catalog = Hipparcos(mag, 180.0).StarsInFOV(Vector(0.0, 0.0, 1.0));
+        int N = catalog.size();
+        vector<double> x(N), y(N), z(N), m(N);
+        for(int i=0; i<N; i++){
+            x[i] = catalog[i].v_eci(0);
+            y[i] = catalog[i].v_eci(1);
+            z[i] = catalog[i].v_eci(2);
+            m[i] = catalog[i].mag;
+        }
+        SkyIndex index;
+        index.Build(x.data(), y.data(), z.data(), m.data(), N, halfFOV_deg*DEG2RAD);
+
+        size_t found = 0;
+        auto t0 = chrono::steady_clock::now();
+        for(auto& n : boresight)
+            found += hsc.StarsInFOV(n).size();
+        double tScan = Seconds(t0);
+
+        vector<int> hits;
+        size_t foundIndex = 0;
+        t0 = chrono::steady_clock::now();
+        for(auto& n : boresight){
+            double v[3] = {n(0), n(1), n(2)};
+            index.Query(v, halfFOV_deg*DEG2RAD, hits);
+            foundIndex += hits.size();
+        }
+        double tIndex = Seconds(t0);
+
+        char name[32];
+        snprintf(name, sizeof(name), "mag%.1f", mag);
+        Record("stars", string(name) + " scan", 1e6*tScan/N_QUERIES, "us");
+        Record("stars", string(name) + " index", 1e6*tIndex/N_QUERIES, "us");
+        printf("%10.1f %10d %14.2f %14.2f %9.1fx%s\n", mag, N,
+               1e6*tScan/N_QUERIES, 1e6*tIndex/N_QUERIES, tScan/tIndex,
+               found == foundIndex ? "" : "  (result count mismatch)");
+    }
+}
+
+// ------------------------------------------------------------------------
+// bulk projection: per-point Matrix/pow() evaluation vs SoA kernels
+// ------------------------------------------------------------------------
+static void ReferenceDistorted(const CameraModel& cam, const Matrix& xyz, Matrix& uv){
+    // the original per-point formulation: AB (1x25) * C, AB * D
+    Matrix C(25,1), D(25,1), AB(1,25);
+    for(int k=0;k<25;k++){ C(k,0) = cam.C[k]; D(k,0) = cam.D[k]; }
+    for(int i=0;i<xyz.nRows();i++){
+        double xn = xyz(i,0) / xyz(i,2);
+        double yn = xyz(i,1) / xyz(i,2);
+        for(int k=0;k<5;k++)
+            for(int j=0;j<5;j++)
+                AB(0,5*k + j) = pow(xn,k) * pow(yn,j);
+        uv(i,0) = (double) ((AB*C)(0,0));
+        uv(i,1) = (double) ((AB*D)(0,0));
+    }
+}
+
+static void BenchProjection(){
+
+    const int N = 1000000;
+    mt19937 rng(BENCH_SEED);
+    uniform_real_distribution<double> fov(-0.2, 0.2), coef(-1e-3, 1e-3);
+
+    CameraModel cam;
+    cam.fpx = 4000.0; cam.fpy = 4000.0; cam.cx = 960.0; cam.cy = 600.0;
+    for(int k=0;k<25;k++){ cam.C[k] = coef(rng); cam.D[k] = coef(rng); }
+    cam.C[1*5 + 0] = cam.fpx; cam.C[0] = cam.cx;      // u ~ fpx*xn + cx
+    cam.D[0*5 + 1] = cam.fpy; cam.D[0] = cam.cy;      // v ~ fpy*yn + cy
+
+    vector<double> x(N), y(N), z(N), u(N), v(N);
+    for(int i=0;i<N;i++){
+        double a = fov(rng), b = fov(rng), n = sqrt(a*a + b*b + 1.0);
+        x[i] = a/n; y[i] = b/n; z[i] = 1.0/n;
+    }
+
+    printf("\n[projection] %d points\n", N);
+    printf("%-28s %14s %14s\n", "kernel", "Mpoints/s", "max |err| [pix]");
+
+    auto t0 = chrono::steady_clock::now();
+    ProjectPinhole(cam, x.data(), y.data(), z.data(), N, u.data(), v.data());
+    double t = Seconds(t0);
+    printf("%-28s %14.1f %14s\n", "ProjectPinhole", N/t*1e-6, "-");
+    Record("projection", "ProjectPinhole", N/t*1e-6, "Mpoints/s");
+
+    t0 = chrono::steady_clock::now();
+    ProjectDistorted(cam, x.data(), y.data(), z.data(), N, u.data(), v.data());
+    t = Seconds(t0);
+
+    // reference on a subset (it allocates per point and is orders of magnitude slower)
+    const int N_REF = 20000;
+    Matrix xyz(N_REF,3), uvRef(N_REF,2);
+    for(int i=0;i<N_REF;i++){ xyz(i,0) = x[i]; xyz(i,1) = y[i]; xyz(i,2) = z[i]; }
+    auto t1 = chrono::steady_clock::now();
+    ReferenceDistorted(cam, xyz, uvRef);
+    double tRef = Seconds(t1);
+    double err = 0.0;
+    for(int i=0;i<N_REF;i++)
+        err = max(err, max(fabs(uvRef(i,0) - u[i]), fabs(uvRef(i,1) - v[i])));
+
+    printf("%-28s %14.1f %14.2e\n", "ProjectDistorted (Horner)", N/t*1e-6, err);
+    Record("projection", "ProjectDistorted", N/t*1e-6, "Mpoints/s");
+    printf("%-28s %14.1f %14s\n", "reference (Matrix, pow)", N_REF/tRef*1e-6, "-");
+
+    vector<double> bx(N), by(N), bz(N);
+    t0 = chrono::steady_clock::now();
+    BackProjectPinhole(cam, u.data(), v.data(), N, bx.data(), by.data(), bz.data());
+    t = Seconds(t0);
+    printf("%-28s %14.1f %14s\n", "BackProjectPinhole", N/t*1e-6, "-");
+    Record("projection", "BackProjectPinhole", N/t*1e-6, "Mpoints/s");
+}
+
+// ------------------------------------------------------------------------
+// CAD startup: CSV/STL parsing (cold) vs memory-mapped mesh cache (warm)
+//   OS_BENCH_ROOT  asset directory (with trailing separator)
+//   OS_BENCH_CSV   assembly CSV, relative to OS_BENCH_ROOT
+// ------------------------------------------------------------------------
+static void BenchLoad(){
+
+    const char* root = getenv("OS_BENCH_ROOT");
+    const char* csv = getenv("OS_BENCH_CSV");
+    if (root == NULL || csv == NULL){
+        printf("\n[load] skipped, set OS_BENCH_ROOT and OS_BENCH_CSV\n");
+        return;
+    }
+    const int N_RUNS = 5;
+
+    GL gl(640, 480, 5.5e-6, 5.5e-6, 0.0176, 0.0176, true, SoftwareRenderer());
+    string fn_cache = string(root) + csv + ".osmc";
+
+    printf("\n[load] %s%s, %d runs\n", root, csv, N_RUNS);
+    printf("%-28s %14s %14s\n", "", "cold [ms]", "warm [ms]");
+
+    for(bool quantize : {false, true}){
+        gl.SetQuantizeNormals(quantize);
+
+        double tCold = 0.0, tWarm = 0.0;
+        for(int i=0; i<N_RUNS; i++){
+            remove(fn_cache.c_str());
+            auto t0 = chrono::steady_clock::now();
+            CAD cold = gl.LoadCAD(root, csv, "", "", 1.0f);
+            Finish(gl);
+            tCold += Seconds(t0);
+
+            // the cold load wrote the cache
+            t0 = chrono::steady_clock::now();
+            CAD warm = gl.LoadCAD(root, csv, "", "", 1.0f);
+            Finish(gl);
+            tWarm += Seconds(t0);
+
+            gl.DeleteCAD(cold);
+            gl.DeleteCAD(warm);
+        }
+        printf("%-28s %14.1f %14.1f\n", quantize ? "LoadCAD (packed normals)" : "LoadCAD",
+               1e3*tCold/N_RUNS, 1e3*tWarm/N_RUNS);
+        Record("load", quantize ? "LoadCAD packed cold" : "LoadCAD cold", 1e3*tCold/N_RUNS, "ms");
+        Record("load", quantize ? "LoadCAD packed warm" : "LoadCAD warm", 1e3*tWarm/N_RUNS, "ms");
+    }
+    remove(fn_cache.c_str());
+
+    // parsing itself: one loader thread vs every core, cache off
+    gl.SetMeshCache(false);
+    gl.SetQuantizeNormals(false);
+    unsigned int cores = thread::hardware_concurrency();
+    printf("%-28s %14s %14s\n", "", "1 thread [ms]", "all cores [ms]");
+    double tSerial = 0.0, tParallel = 0.0;
+    for(int i=0; i<N_RUNS; i++){
+        for(int nThreads : {1, 0}){
+            AssetLoader loader(gl);
+            loader.AddCAD(root, csv, "", "", 1.0f);
+            auto t0 = chrono::steady_clock::now();
+            CAD cad = loader.Load(nThreads)[0];
+            Finish(gl);
+            (nThreads == 1 ? tSerial : tParallel) += Seconds(t0);
+            gl.DeleteCAD(cad);
+        }
+    }
+    printf("%-28s %14.1f %14.1f   (%u cores)\n", "AssetLoader, no cache", 1e3*tSerial/N_RUNS,
+           1e3*tParallel/N_RUNS, cores);
+    Record("load", "AssetLoader 1 thread", 1e3*tSerial/N_RUNS, "ms");
+    Record("load", "AssetLoader all cores", 1e3*tParallel/N_RUNS, "ms");
+}
+
+// ------------------------------------------------------------------------
+// RenderTango at several resolutions over the checked-in pose set, same
+// field of view as the scene camera
+// ------------------------------------------------------------------------
+static void BenchRender(){
+
+    const char* fn_scene = getenv("OS_BENCH_SCENE");
+    if (fn_scene == NULL)
+        fn_scene = DEFAULT_SCENE;
+    const char* fn_poses = getenv("OS_BENCH_POSES");
+    if (fn_poses == NULL)
+        fn_poses = DEFAULT_POSES;
+    PoseTable poses;
+    if (!poses.Load(fn_poses) || poses.Rows() == 0){
+        printf("\n[render] cannot load poses from %s\n", fn_poses);
+        exit(1);
+    }
+
+    SceneConfig scene;
+    scene.Load(fn_scene);
+    const int sizes[][2] = {{640, 480}, {1280, 960}, {1920, 1440}};
+    const int N_WARMUP = 4;
+
+    printf("\n[render] %d poses, %s\n", poses.Rows(), fn_scene);
+    printf("%-12s %12s %12s %12s %14s\n", "size", "p50 [ms]", "p95 [ms]", "mean [ms]", "batch [fps]");
+
+    vector<S3> states;
+    for(int i=0; i<poses.Rows(); i++)
+        states.push_back(PoseState(poses, i));
+
+    for(const auto& size : sizes){
+        int Nu = size[0], Nv = size[1];
+        double ppx = scene.Number("ppx") * scene.Number("Nu") / Nu;
+        double ppy = scene.Number("ppy") * scene.Number("Nv") / Nv;
+        OpticalStimulator os(Nu, Nv, ppx, ppy, scene.Number("fx"), scene.Number("fy"),
+                             scene.Number("magThresh"), scene.Number("halfFOV"), Identity3(), true,
+                             SoftwareRenderer());
+        scene.LoadBodies(os.m_gl);
+        scene.ApplyStarPSF(os.m_gl);
+        scene.ApplySensor(os.m_gl);
+        if (!poses.HasFull())
+            os.m_gl.m_earth.on = false;
+
+        // Finish per frame: the GPU time is part of the frame, not of the next one
+        for(int i=0; i<N_WARMUP; i++)
+            os.RenderTango(states[i % states.size()]);
+        Finish(os.m_gl);
+        vector<double> ms;
+        double total = 0.0;
+        for(const auto& s3 : states){
+            auto t0 = chrono::steady_clock::now();
+            os.RenderTango(s3);
+            Finish(os.m_gl);
+            ms.push_back(1e3*Seconds(t0));
+            total += ms.back();
+        }
+
+        vector<unsigned char> frames;
+        auto t0 = chrono::steady_clock::now();
+        os.RenderTangoBatch(states, frames);
+        double fps = states.size() / Seconds(t0);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%dx%d", Nu, Nv);
+        double p50 = Percentile(ms, 0.50), p95 = Percentile(ms, 0.95);
+        printf("%-12s %12.2f %12.2f %12.2f %14.1f\n", name, p50, p95, total/states.size(), fps);
+        Record("render", string(name) + " p50", p50, "ms");
+        Record("render", string(name) + " p95", p95, "ms");
+        Record("render", string(name) + " batch", fps, "fps");
+
+        // a scene with the sun on should have its bodies shadowed (shaders opt in, see ShadowMap)
+        if (!os.m_gl.m_software && os.m_gl.m_sun.initialized && os.m_gl.m_shadowSize > 0 &&
+            os.m_gl.m_shadowedDraws == 0)
+            printf("%-12s no draw was sun-shadowed, the body shaders do not sample sunShadow\n", name);
+        Record("render", string(name) + " shadowed draws", os.m_gl.m_shadowedDraws, "draws");
+    }
+}
+
+// ------------------------------------------------------------------------
+// tiled frames (RenderTangoTiled) against the untiled batch path, on the
+// scene camera with non-square pixels: both go through one frustum, so the
+// tiles must put the body on the same pixels (fails the run otherwise)
+// ------------------------------------------------------------------------
+static void BenchTiling(){
+
+    const char* fn_scene = getenv("OS_BENCH_SCENE");
+    if (fn_scene == NULL)
+        fn_scene = DEFAULT_SCENE;
+    const char* fn_poses = getenv("OS_BENCH_POSES");
+    if (fn_poses == NULL)
+        fn_poses = DEFAULT_POSES;
+    PoseTable poses;
+    if (!poses.Load(fn_poses) || poses.Rows() == 0){
+        printf("\n[tiling] cannot load poses from %s\n", fn_poses);
+        exit(1);
+    }
+
+    SceneConfig scene;
+    scene.Load(fn_scene);
+    const int Nu = 640, Nv = 480, TILE = 200;      // tiles that do not divide the frame
+    const int N_FRAMES = min(8, poses.Rows());
+    const int TOLERANCE = 8;                        // grey levels, rasterization along tile seams
+
+    // pixels 25% wider than tall: separates the horizontal from the vertical field of view
+    double ppy = scene.Number("ppy") * scene.Number("Nv") / Nv;
+    double ppx = 1.25 * ppy;
+    OpticalStimulator os(Nu, Nv, ppx, ppy, scene.Number("fx"), scene.Number("fy"),
+                         scene.Number("magThresh"), scene.Number("halfFOV"), Identity3(), true,
+                         SoftwareRenderer());
+    scene.LoadBodies(os.m_gl);
+    if (!poses.HasFull())
+        os.m_gl.m_earth.on = false;
+
+    vector<S3> states;
+    for(int i=0; i<N_FRAMES; i++)
+        states.push_back(PoseState(poses, i));
+    vector<unsigned char> frames;
+    os.RenderTangoBatch(states, frames);
+
+    printf("\n[tiling] %dx%d in %dx%d tiles, %d poses, %s\n", Nu, Nv, TILE, TILE, N_FRAMES, fn_scene);
+    printf("%-8s %12s %14s\n", "pose", "tiled [ms]", "mismatch [%]");
+
+    os.m_gl.SetTileSize(TILE);
+    size_t framePixels = (size_t) Nu * Nv;
+    size_t mismatched = 0;
+    vector<unsigned char> tiled;
+    for(int i=0; i<N_FRAMES; i++){
+        auto t0 = chrono::steady_clock::now();
+        if (!os.RenderTangoTiled(states[i], tiled))
+            throw runtime_error("tiling: RenderTangoTiled failed\n");
+        double ms = 1e3*Seconds(t0);
+
+        const unsigned char* untiled = &frames[3 * framePixels * i];
+        size_t bad = 0;
+        for(size_t p=0; p<framePixels; p++)
+            for(int c=0; c<3; c++)
+                if (abs((int) tiled[3*p + c] - (int) untiled[3*p + c]) > TOLERANCE){
+                    bad++;
+                    break;
+                }
+        mismatched += bad;
+        printf("%-8d %12.2f %14.3f\n", i, ms, 100.0 * bad / framePixels);
+        Record("tiling", "pose " + to_string(i) + " tiled", ms, "ms");
+    }
+    os.m_gl.SetTileSize(0);
+
+    double fraction = (double) mismatched / (framePixels * N_FRAMES);
+    Record("tiling", "mismatch", 100.0 * fraction, "%");
+    if (fraction > 1e-3)
+        throw runtime_error("tiling: tiled frames do not match the untiled ones\n");
+}
+
+// ------------------------------------------------------------------------
+// star field frames (RenderQuat) vs magThresh over a slow attitude sweep:
+// catalog query, gather and the PSF splat pass (no star body needed)
+// ------------------------------------------------------------------------
+static void BenchStarField(){
+
+    const double magThresh[] = {4.0, 5.0, 6.0, 7.0, 8.0};
+    const int N_FRAMES = 500;
+
+    SceneConfig scene;
+    const char* fn_scene = getenv("OS_BENCH_SCENE");
+    scene.Load(fn_scene != NULL ? fn_scene : DEFAULT_SCENE);
+    bool camera = scene.Has("Nu");
+    int Nu = camera ? (int) scene.Number("Nu") : 1280;
+    int Nv = camera ? (int) scene.Number("Nv") : 960;
+    double ppx = camera ? scene.Number("ppx") : 5.5e-6, ppy = camera ? scene.Number("ppy") : 5.5e-6;
+    double fx = camera ? scene.Number("fx") : 0.0176, fy = camera ? scene.Number("fy") : 0.0176;
+    double halfFOV = camera ? scene.Number("halfFOV") : 20.0;
+
+    // attitude sweep: quaternion rotating 0.05 deg per frame about a random axis
+    mt19937 rng(BENCH_SEED);
+    normal_distribution<double> gauss;
+    double axis[3] = {gauss(rng), gauss(rng), gauss(rng)};
+    double n = sqrt(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+    vector<Vector> q;
+    for(int i=0; i<N_FRAMES; i++){
+        double h = 0.5 * i * 0.05 * DEG2RAD;
+        q.push_back(Vector(cos(h), sin(h)*axis[0]/n, sin(h)*axis[1]/n, sin(h)*axis[2]/n));
+    }
+
+    printf("\n[starfield] %dx%d, %d frames\n", Nu, Nv, N_FRAMES);
+    printf("%10s %12s %12s %12s\n", "magThresh", "p50 [ms]", "p95 [ms]", "mean [ms]");
+
+    for(double mag : magThresh){
+        OpticalStimulator os(Nu, Nv, ppx, ppy, fx, fy, mag, halfFOV, Identity3(), true, SoftwareRenderer());
+        scene.ApplyStarPSF(os.m_gl);
+
+        vector<double> ms;
+        double total = 0.0;
+        for(const auto& qi : q){
+            auto t0 = chrono::steady_clock::now();
+            os.RenderQuat(qi);
+            Finish(os.m_gl);
+            ms.push_back(1e3*Seconds(t0));
+            total += ms.back();
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "mag%.1f", mag);
+        double p50 = Percentile(ms, 0.50), p95 = Percentile(ms, 0.95);
+        printf("%10.1f %12.3f %12.3f %12.3f\n", mag, p50, p95, total/N_FRAMES);
+        Record("starfield", string(name) + " p50", p50, "ms");
+        Record("starfield", string(name) + " p95", p95, "ms");
+    }
+}
+
+// ------------------------------------------------------------------------
+// image encode (one thread, per format) and the whole screenshot pipeline
+// (readback ring + writer pool) on a fixed synthetic frame
+// ------------------------------------------------------------------------
+static void BenchEncode(){
+
+    const int Nu = 1920, Nv = 1200, N_FRAMES = 20, N_SCREENSHOTS = 60;
+    const char* tmp = getenv("OS_BENCH_TMP");
+    string dir = tmp != NULL ? tmp : ".";
+
+    // dark background with a smooth body and sensor-like noise: compresses like a render
+    mt19937 rng(BENCH_SEED);
+    normal_distribution<double> noise(0.0, 2.0);
+    vector<unsigned char> pixels(3*Nu*Nv);
+    for(int v=0; v<Nv; v++)
+        for(int u=0; u<Nu; u++){
+            double du = (u - 0.5*Nu) / Nv, dv = (v - 0.5*Nv) / Nv;
+            double body = (du*du + dv*dv < 0.1) ? 120.0 + 100.0*du : 4.0;
+            for(int c=0; c<3; c++)
+                pixels[3*(v*Nu + u) + c] = (unsigned char) max(0.0, min(255.0, body + noise(rng)));
+        }
+
+    GL gl(Nu, Nv, 5.5e-6, 5.5e-6, 0.0176, 0.0176, true, SoftwareRenderer());
+
+    printf("\n[encode] %dx%d RGB, %d frames per format, 1 thread\n", Nu, Nv, N_FRAMES);
+    printf("%-12s %12s %12s %14s\n", "format", "ms/frame", "MB/s in", "bytes/frame");
+    for(const char* ext : {"png", "jpg", "bmp", "tga"}){
+        string fn = dir + "/os_bench_encode." + ext;
+        auto t0 = chrono::steady_clock::now();
+        for(int i=0; i<N_FRAMES; i++)
+            gl.WriteImage(fn, (const char*) pixels.data(), Nu, Nv, 3);
+        double t = Seconds(t0) / N_FRAMES;
+
+        FILE* f = fopen(fn.c_str(), "rb");
+        long bytes = 0;
+        if (f != NULL){
+            fseek(f, 0, SEEK_END);
+            bytes = ftell(f);
+            fclose(f);
+        }
+        remove(fn.c_str());
+        printf("%-12s %12.2f %12.1f %14ld\n", ext, 1e3*t, pixels.size()/t*1e-6, bytes);
+        Record("encode", ext, 1e3*t, "ms");
+    }
+
+    // ClearScreen + Screenshot: GPU readback ring feeding the writer pool
+    auto t0 = chrono::steady_clock::now();
+    for(int i=0; i<N_SCREENSHOTS; i++){
+        char name[64];
+        snprintf(name, sizeof(name), "/os_bench_shot_%03d.png", i);
+        gl.ClearScreen();
+        gl.SwapBuffers();
+        gl.Screenshot(dir + name);
+    }
+    gl.FlushScreenshots();
+    double fps = N_SCREENSHOTS / Seconds(t0);
+    for(int i=0; i<N_SCREENSHOTS; i++){
+        char name[64];
+        snprintf(name, sizeof(name), "/os_bench_shot_%03d.png", i);
+        remove((dir + name).c_str());
+    }
+    printf("%-12s %12.2f fps (%d writer threads)\n", "Screenshot", fps,
+           max(1, (int) thread::hardware_concurrency() - 1));
+    Record("encode", "Screenshot pipeline", fps, "fps");
+}
+
+int main(int argc, char** argv){
+
+    struct Section { const char* name; void (*run)(); };
+    const Section sections[] = {
+        {"stars", BenchStarQuery},
+        {"projection", BenchProjection},
+        {"load", BenchLoad},
+        {"render", BenchRender},
+        {"tiling", BenchTiling},
+        {"starfield", BenchStarField},
+        {"encode", BenchEncode},
+    };
+
+    // reproducible numbers across machines: Mesa's software rasterizer unless asked otherwise
+    if (getenv("OS_BENCH_HARDWARE") == NULL){
+#ifdef _WIN32
+        _putenv_s("LIBGL_ALWAYS_SOFTWARE", "1");
+        _putenv_s("GALLIUM_DRIVER", "llvmpipe");
+#else
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+        setenv("GALLIUM_DRIVER", "llvmpipe", 0);
+#endif
+    }
+
+    try {
+        for(const auto& section : sections){
+            bool selected = (argc == 1);
+            for(int i=1; i<argc; i++)
+                selected = selected || strcmp(argv[i], section.name) == 0;
+            if (selected)
+                section.run();
+        }
+    }
+    catch (const exception& e){
+        printf("%s", e.what());
+        return 1;
+    }
+
+    const char* fn_json = getenv("OS_BENCH_JSON");
+    if (fn_json != NULL)
+        WriteResults(fn_json);
+    return 0;
+}
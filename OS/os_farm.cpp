@@ -0,0 +1,409 @@
+// OS_FARM.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: render-farm driver, renders a pose table with N headless
+//              renderer processes, no MATLAB in the loop
+//
+//   os_farm --scene scene.cfg --poses poses.csv|poses.bin --out DIR
+//           [--workers N] [--prefix img] [--ext png] [--batch 32] [--profile 1]
+//           [--size 256x256] [--luma 1] [--roi 0.1] [--records 1024] [--labels 1]
+//           [--tile 2048]
+//
+//   --workers N (default: all cores) starts N copies of itself with
+//   --shard k/N, each rendering rows k, k+N, k+2N, ... into DIR with one
+//   GL context per process; the parent waits and merges the per-shard
+//   manifests into DIR/manifest.csv. Image names depend on the row only
+//   (<prefix>_<row:08d>.<ext>), so output is identical for any N.
+//   --ext is png, jpg, bmp or tga for image files, ppm for tiled frames.
+//   --ext tfrecord streams raw frames into training shards instead of
+//   image files (see ShardWriter): <prefix>.shard<k>-<n>.tfrecord with
+//   --records frames each, the manifest names "<shard file>#<record>".
+//   --size WxH scales frames on the GPU before readback (any output),
+//   --luma 1 reduces them to one grey channel, --roi margin crops them to
+//   the projected Tango box grown by margin (manifest columns roi_*: the
+//   crop in camera pixels, x0 y0 x1 y1 from the bottom-left corner).
+//   --labels 1 (tfrecord only) adds the ground truth of every frame to the
+//   records: "mask" (uint16 part id + 1, 0 = background), "depth" (float32
+//   [m] along the boresight) at camera size, bottom-up like the image, and
+//   "keypoints" (float32 {8, 3}: u, v [pix, from the top-left], z [m] of
+//   the Tango box corners).
+//   --tile N renders every frame in N x N tiles streamed into a binary
+//   PPM (--ext ppm), for frames beyond the framebuffer limits; frames that
+//   exceed them are tiled without it.
+//   sensor.on = 1 in the scene file adds the camera sensor model (blur,
+//   vignetting, noise, ADC) to every frame before readback; its noise is
+//   keyed by row and sensor.seed, so it is also identical for any N.
+//   --profile 1 writes per-stage timings of every shard to
+//   DIR/profile.shard<k>.json and .trace.json (see Profiler).
+//   OS_RENDERER=software in the environment (inherited by the workers)
+//   renders on the CPU rasterizer, for nodes without any GL driver; every
+//   option above works except --labels.
+//
+//   scene.cfg: see SceneConfig
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_gl.hpp"
+#include "os_opticalstimulator.hpp"
+#include "os_posetable.hpp"
+#include "os_scene.hpp"
+#include "os_shardwriter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct FarmOptions
+{
+    string scene;
+    string poses;
+    string out;
+    string prefix = "img";
+    string ext = "png";
+    int batch = 32;
+    bool profile = false;
+    int width = 0;                      // output size, 0: camera size
+    int height = 0;
+    bool luma = false;
+    float roi = -1.0f;                  // crop margin, < 0: full frame
+    int records = 1024;                 // frames per tfrecord shard
+    bool labels = false;
+    int tile = 0;                       // tile size, 0: untiled unless the frame needs it
+    int workers = 0;                    // <= 0: all cores
+    int shard = -1;                     // -1: parent
+    int nShards = 1;
+    bool software = false;              // OS_RENDERER=software
+};
+
+static void Usage(){
+    printf("usage: os_farm --scene scene.cfg --poses poses.csv|.bin --out DIR\n"
+           "               [--workers N] [--prefix img] [--ext png] [--batch 32] [--profile 1] [--shard k/N]\n"
+           "               [--size WxH] [--luma 1] [--roi margin] [--records 1024] [--labels 1]\n"
+           "               [--tile N]\n");
+}
+
+static bool ParseArgs(int argc, char** argv, FarmOptions& opt){
+    const char* renderer = getenv("OS_RENDERER");
+    opt.software = renderer != NULL && string(renderer) == "software";
+    for(int i=1; i<argc; i++){
+        string key = argv[i];
+        if (i + 1 >= argc){
+            printf("os_farm: missing value for %s\n", key.c_str());
+            return false;
+        }
+        string value = argv[++i];
+        if      (key == "--scene")   opt.scene = value;
+        else if (key == "--poses")   opt.poses = value;
+        else if (key == "--out")     opt.out = value;
+        else if (key == "--prefix")  opt.prefix = value;
+        else if (key == "--ext")     opt.ext = value;
+        else if (key == "--batch")   opt.batch = max(1, atoi(value.c_str()));
+        else if (key == "--workers") opt.workers = atoi(value.c_str());
+        else if (key == "--profile") opt.profile = atoi(value.c_str()) != 0;
+        else if (key == "--records") opt.records = atoi(value.c_str());
+        else if (key == "--tile")    opt.tile = atoi(value.c_str());
+        else if (key == "--labels")  opt.labels = atoi(value.c_str()) != 0;
+        else if (key == "--luma")    opt.luma = atoi(value.c_str()) != 0;
+        else if (key == "--roi")     opt.roi = (float) atof(value.c_str());
+        else if (key == "--size"){
+            if (sscanf(value.c_str(), "%dx%d", &opt.width, &opt.height) != 2 || opt.width < 1 || opt.height < 1){
+                printf("os_farm: bad size %s\n", value.c_str());
+                return false;
+            }
+        }
+        else if (key == "--shard"){
+            if (sscanf(value.c_str(), "%d/%d", &opt.shard, &opt.nShards) != 2 ||
+                opt.nShards < 1 || opt.shard < 0 || opt.shard >= opt.nShards){
+                printf("os_farm: bad shard %s\n", value.c_str());
+                return false;
+            }
+        }
+        else {
+            printf("os_farm: unknown option %s\n", key.c_str());
+            return false;
+        }
+    }
+    const char* exts[] = {"png", "jpg", "bmp", "tga", "ppm", "tfrecord"};
+    if (find(begin(exts), end(exts), opt.ext) == end(exts)){
+        printf("os_farm: unsupported --ext %s (png, jpg, bmp, tga, tfrecord, or ppm with --tile)\n", opt.ext.c_str());
+        return false;
+    }
+    if (opt.labels && opt.ext != "tfrecord"){
+        printf("os_farm: --labels needs --ext tfrecord\n");
+        return false;
+    }
+    return !opt.scene.empty() && !opt.poses.empty() && !opt.out.empty();
+}
+
+// ------------------------------------------------------------------------
+// shard: one process, one headless context
+// ------------------------------------------------------------------------
+static string ImageName(const FarmOptions& opt, int row){
+    char name[64];
+    snprintf(name, sizeof(name), "_%08d.", row);
+    return opt.prefix + name + opt.ext;
+}
+
+static string ManifestName(const FarmOptions& opt, int shard){
+    char name[64];
+    snprintf(name, sizeof(name), "/manifest.shard%03d.csv", shard);
+    return opt.out + name;
+}
+
+static int RunShard(const FarmOptions& opt, const PoseTable& poses){
+
+    SceneConfig scene;
+    scene.Load(opt.scene);
+
+    Matrix R_vbs2os(3, 3);
+    for(int i=0; i<3; i++)
+        for(int j=0; j<3; j++)
+            R_vbs2os(i, j) = (i == j) ? 1.0 : 0.0;
+
+    OpticalStimulator os((int) scene.Number("Nu"), (int) scene.Number("Nv"),
+                         scene.Number("ppx"), scene.Number("ppy"), scene.Number("fx"), scene.Number("fy"),
+                         scene.Number("magThresh"), scene.Number("halfFOV"), R_vbs2os, true, opt.software);
+    scene.LoadBodies(os.m_gl);
+    scene.ApplyStarPSF(os.m_gl);
+    scene.ApplySensor(os.m_gl);
+    if (!poses.HasFull())
+        os.m_gl.m_earth.on = false;
+    os.m_gl.SetProfiling(opt.profile);
+    os.m_gl.SetOutputSize(opt.width, opt.height);
+    os.m_gl.SetOutputLuma(opt.luma);
+    os.m_gl.SetOutputROI(opt.roi >= 0.0f, opt.roi);
+    os.SetLabels(opt.labels);
+    os.m_gl.SetTileSize(opt.tile);
+
+    // sensor noise keyed by row: this shard renders rows k, k+N, ...
+    os.m_gl.SetSensorFrames((unsigned int) opt.shard, (unsigned int) opt.nShards);
+
+    // tiled frames are streamed, none of the whole-frame outputs apply
+    bool tiled = os.m_gl.Tiled();
+    if (tiled && (opt.ext != "ppm" || opt.width > 0 || opt.luma || opt.roi >= 0.0f || opt.labels || os.m_gl.m_sensor.on)){
+        printf("os_farm: tiled frames need --ext ppm, without --size, --luma, --roi, --labels and sensor.on\n");
+        return 1;
+    }
+    if (!tiled && opt.ext == "ppm"){
+        printf("os_farm: --ext ppm is only written for tiled frames (--tile)\n");
+        return 1;
+    }
+
+    // raw tensor output: one shard series per process
+    bool tensors = (opt.ext == "tfrecord");
+    ShardWriter writer;
+    if (tensors){
+        char name[64];
+        snprintf(name, sizeof(name), ".shard%03d", opt.shard);
+        TensorSpec image;
+        image.name = "image";
+        image.type = TENSOR_UINT8;
+        image.shape = {(int64_t) os.m_gl.OutputHeight(), (int64_t) os.m_gl.OutputWidth(),
+                       (int64_t) os.m_gl.OutputChannels()};
+        vector<TensorSpec> schema(1, image);
+        if (opt.labels){
+            TensorSpec mask, depth, keypoints;
+            mask.name = "mask";
+            mask.type = TENSOR_UINT16;
+            mask.shape = {(int64_t) os.m_gl.m_camera.Nv, (int64_t) os.m_gl.m_camera.Nu, 1};
+            depth.name = "depth";
+            depth.type = TENSOR_FLOAT32;
+            depth.shape = mask.shape;
+            // projecting once fixes the keypoint set (default: the box corners)
+            os.ProjectKeypoints(os.m_gl.m_tango);
+            keypoints.name = "keypoints";
+            keypoints.type = TENSOR_FLOAT32;
+            keypoints.shape = {(int64_t) os.m_keypointsUV.size() / 3, 3};
+            schema.push_back(mask);
+            schema.push_back(depth);
+            schema.push_back(keypoints);
+        }
+        if (!writer.Open(opt.out + "/" + opt.prefix + name, schema, opt.records))
+            return 1;
+    }
+
+    FILE* manifest = fopen(ManifestName(opt, opt.shard).c_str(), "w");
+    if (manifest == NULL){
+        printf("os_farm: cannot write manifest in %s\n", opt.out.c_str());
+        return 1;
+    }
+
+    // rows k, k+N, ...: neighbouring rows (similar range, similar cost) spread over all shards;
+    // manifest rows are held back until every image is known to be on disk
+    vector<string> lines;
+    vector<S3> states;
+    vector<string> filenames;
+    vector<int64_t> rows;
+    for(int row=opt.shard; row<poses.Rows(); row+=opt.nShards){
+        states.push_back(PoseState(poses, row));
+        filenames.push_back(opt.out + "/" + ImageName(opt, row));
+        rows.push_back(row);
+        if ((int) states.size() == opt.batch || row + opt.nShards >= poses.Rows()){
+            vector<string> locations;
+            if (tensors){
+                int64_t first = writer.Written();
+                os.RenderTangoBatch(states, rows, writer);
+                for(size_t i=0; i<rows.size(); i++){
+                    string location = writer.Location(first + i);
+                    locations.push_back(location.substr(location.find_last_of("/\\") + 1));
+                }
+            }
+            else if (tiled){
+                for(size_t i=0; i<rows.size(); i++){
+                    if (!os.RenderTangoTiled(states[i], filenames[i])){
+                        printf("os_farm: cannot write %s\n", filenames[i].c_str());
+                        return 1;
+                    }
+                    locations.push_back(ImageName(opt, (int) rows[i]));
+                }
+            }
+            else {
+                os.RenderTangoBatch(states, filenames);
+                for(size_t i=0; i<rows.size(); i++)
+                    locations.push_back(ImageName(opt, (int) rows[i]));
+            }
+            for(size_t i=0; i<rows.size(); i++){
+                const double* p = poses.Row((int) rows[i]);
+                char field[64];
+                string line = to_string(rows[i]) + "," + locations[i];
+                for(int c=0; c<PoseTable::POSE_COLS_TANGO; c++){
+                    snprintf(field, sizeof(field), ",%.17g", p[c]);
+                    line += field;
+                }
+                if (opt.roi >= 0.0f)
+                    for(int c=0; c<4; c++){
+                        snprintf(field, sizeof(field), ",%.3f", os.m_frameRegions[4*i + c]);
+                        line += field;
+                    }
+                lines.push_back(line);
+            }
+            states.clear();
+            filenames.clear();
+            rows.clear();
+        }
+    }
+
+    // images are encoded on the writer pool, wait for them before reporting success
+    if (!os.m_gl.FlushScreenshots()){
+        printf("os_farm: shard %d failed to write some images\n", opt.shard);
+        fclose(manifest);
+        return 1;
+    }
+    for(const auto& line : lines)
+        fprintf(manifest, "%s\n", line.c_str());
+    if (opt.profile){
+        char name[64];
+        snprintf(name, sizeof(name), "/profile.shard%03d", opt.shard);
+        os.m_gl.SaveProfile(opt.out + name);
+    }
+    return fclose(manifest) == 0 ? 0 : 1;
+}
+
+// ------------------------------------------------------------------------
+// parent: spawn the shards, merge their manifests
+// ------------------------------------------------------------------------
+static string Quote(const string& s){
+#ifdef _WIN32
+    return "\"" + s + "\"";
+#else
+    string quoted = "'";
+    for(char c : s)
+        quoted += (c == '\'') ? string("'\\''") : string(1, c);
+    return quoted + "'";
+#endif
+}
+
+static int RunFarm(const char* self, const FarmOptions& opt, int nRows){
+
+    int nShards = opt.workers > 0 ? opt.workers : (int) max(1u, thread::hardware_concurrency());
+    nShards = max(1, min(nShards, nRows));
+
+    // one blocking system() per shard, each from its own thread, so the shards run concurrently
+    vector<int> status(nShards, 0);
+    vector<thread> threads;
+    for(int k=0; k<nShards; k++){
+        string cmd = Quote(self) + " --scene " + Quote(opt.scene) + " --poses " + Quote(opt.poses) +
+                     " --out " + Quote(opt.out) + " --prefix " + Quote(opt.prefix) + " --ext " + Quote(opt.ext) +
+                     " --batch " + to_string(opt.batch) + " --records " + to_string(opt.records) +
+                     " --labels " + (opt.labels ? "1" : "0") + " --tile " + to_string(opt.tile) +
+                     (opt.width > 0 ? " --size " + to_string(opt.width) + "x" + to_string(opt.height) : string()) +
+                     (opt.luma ? " --luma 1" : "") + (opt.roi >= 0.0f ? " --roi " + to_string(opt.roi) : string()) +
+                     " --profile " + (opt.profile ? "1" : "0") + " --shard " + to_string(k) + "/" + to_string(nShards);
+        threads.emplace_back([cmd, k, &status](){ status[k] = system(cmd.c_str()); });
+    }
+    for(auto& t : threads)
+        t.join();
+
+    int failed = 0;
+    for(int k=0; k<nShards; k++)
+        if (status[k] != 0){
+            printf("os_farm: shard %d/%d failed (status %d)\n", k, nShards, status[k]);
+            failed++;
+        }
+
+    // the shards interleave rows, so the merged manifest is sorted back into pose order
+    vector<pair<int, string>> lines;
+    for(int k=0; k<nShards; k++){
+        string path = ManifestName(opt, k);
+        ifstream in(path.c_str());
+        string line;
+        while (getline(in, line))
+            if (!line.empty())
+                lines.push_back(make_pair(atoi(line.c_str()), line));
+        in.close();
+        remove(path.c_str());
+    }
+    sort(lines.begin(), lines.end());
+
+    FILE* manifest = fopen((opt.out + "/manifest.csv").c_str(), "w");
+    if (manifest == NULL){
+        printf("os_farm: cannot write %s/manifest.csv\n", opt.out.c_str());
+        return 1;
+    }
+    fprintf(manifest, "row,image,r_Vo2To_vbs_x,r_Vo2To_vbs_y,r_Vo2To_vbs_z,"
+                      "q_vbs2tango_0,q_vbs2tango_1,q_vbs2tango_2,q_vbs2tango_3,"
+                      "r_Vo2So_vbs_x,r_Vo2So_vbs_y,r_Vo2So_vbs_z%s\n",
+                      opt.roi >= 0.0f ? ",roi_x0,roi_y0,roi_x1,roi_y1" : "");
+    for(const auto& line : lines)
+        fprintf(manifest, "%s\n", line.second.c_str());
+    fclose(manifest);
+
+    printf("os_farm: %d of %d frames on %d shards\n", (int) lines.size(), nRows, nShards);
+    return (failed == 0 && (int) lines.size() == nRows) ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+
+    FarmOptions opt;
+    if (!ParseArgs(argc, argv, opt)){
+        Usage();
+        return 2;
+    }
+
+    PoseTable poses;
+    if (!poses.Load(opt.poses))
+        return 1;
+
+    try {
+        if (opt.shard >= 0)
+            return RunShard(opt, poses);
+        return RunFarm(argv[0], opt, poses.Rows());
+    }
+    catch (const exception& e){
+        printf("%s", e.what());
+        return 1;
+    }
+}
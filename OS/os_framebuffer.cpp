@@ -0,0 +1,201 @@
+// OS_FRAMEBUFFER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: offscreen render target (color + depth) used when the
+//              stimulator renders without an on-screen window
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_framebuffer.hpp"
+
+#include <cstring>
+#include <iostream>
+
+void ReadTextureLayers(GLuint texture, GLenum format, GLenum type, size_t layerBytes, int N, int layers,
+                       GLuint& pbo, size_t& pboBytes, void* out){
+
+    // glGetTexImage has no layer range in GL 3.3; a GPU-side copy of the unused layers is
+    // far cheaper than a client round trip per layer
+    size_t arrayBytes = layerBytes * layers;
+    if (pbo == 0)
+        glGenBuffers(1, &pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+    if (pboBytes < arrayBytes){
+        glBufferData(GL_PIXEL_PACK_BUFFER, arrayBytes, NULL, GL_STREAM_READ);
+        pboBytes = arrayBytes;
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, format, type, (void*) 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    const void* p = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, layerBytes * N, GL_MAP_READ_BIT);
+    if (p != NULL){
+        std::memcpy(out, p, layerBytes * N);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+        std::cout << "Failed to map the layer readback buffer" << std::endl;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+Framebuffer::Framebuffer() :
+    m_width(0),
+    m_height(0),
+    m_layers(0),
+    m_colorFormat(GL_RGBA8),
+    m_fbo(0),
+    m_color(0),
+    m_depth(0),
+    m_pbo(0),
+    m_pboBytes(0),
+    m_initialized(false)
+{
+}
+
+bool Framebuffer::Create(int width, int height, GLenum colorFormat){
+
+    // release any previous allocation
+    Delete();
+
+    m_width = width;
+    m_height = height;
+    m_colorFormat = colorFormat;
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+    // color attachment (8-bit RGBA keeps rows 4-byte aligned for readback)
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, colorFormat, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+
+    // depth attachment
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    m_initialized = true;
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        std::cout << "Framebuffer is incomplete (" << width << "x" << height << ")" << std::endl;
+        Delete();
+        return false;
+    }
+
+    glViewport(0, 0, m_width, m_height);
+    return true;
+}
+
+bool Framebuffer::CreateLayered(int width, int height, int layers, GLenum colorFormat){
+
+    // release any previous allocation
+    Delete();
+
+    GLint maxLayers;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (layers < 1 || layers > maxLayers){
+        std::cout << "Requested " << layers << " layers, GL supports at most " << maxLayers << std::endl;
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_layers = layers;
+    m_colorFormat = colorFormat;
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+    // color attachment, one texture layer per frame
+    glGenTextures(1, &m_color);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_color);
+    GLenum type = (colorFormat == GL_RGBA8) ? GL_UNSIGNED_BYTE : GL_FLOAT;
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, colorFormat, width, height, layers, 0, GL_RGBA, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_color, 0, 0);
+
+    // depth attachment, cleared between frames so a single plane is enough
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    m_initialized = true;
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
+        std::cout << "Layered framebuffer is incomplete (" << width << "x" << height << "x" << layers << ")" << std::endl;
+        Delete();
+        return false;
+    }
+
+    glViewport(0, 0, m_width, m_height);
+    return true;
+}
+
+void Framebuffer::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (m_layers > 0)
+        glDeleteTextures(1, &m_color);
+    else
+        glDeleteRenderbuffers(1, &m_color);
+    glDeleteRenderbuffers(1, &m_depth);
+    glDeleteFramebuffers(1, &m_fbo);
+    if (m_pbo != 0)
+        glDeleteBuffers(1, &m_pbo);
+    m_pbo = 0;
+    m_pboBytes = 0;
+    m_layers = 0;
+    m_fbo = 0;
+    m_color = 0;
+    m_depth = 0;
+    m_initialized = false;
+}
+
+void Framebuffer::Bind(){
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::BindLayer(int layer){
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_color, 0, layer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::ReadLayersRGB(int N, unsigned char* out){
+    ReadLayers(N, 3, out);
+}
+
+void Framebuffer::ReadLayers(int N, int channels, unsigned char* out){
+
+    GLenum format = (channels == 1) ? GL_RED : GL_RGB;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if (N == m_layers){
+        // whole array in a single transfer
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_color);
+        glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, format, GL_UNSIGNED_BYTE, out);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+    else{
+        // partially filled batch: one transfer through the pack buffer, only the rendered layers copied
+        size_t frameBytes = (size_t) channels * m_width * m_height;
+        ReadTextureLayers(m_color, format, GL_UNSIGNED_BYTE, frameBytes, N, m_layers, m_pbo, m_pboBytes, out);
+    }
+}
+
+void Framebuffer::Unbind(){
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
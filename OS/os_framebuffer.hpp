@@ -0,0 +1,62 @@
+// OS_FRAMEBUFFER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: offscreen render target (color + depth) used when the
+//              stimulator renders without an on-screen window
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_FRAMEBUFFER_HPP
+#define OS_FRAMEBUFFER_HPP
+
+#include "include/glad/glad.h"
+
+#include <cstddef>
+
+// first N of 'layers' layers of a texture array into 'out' with one transfer: the whole array is
+// packed into 'pbo' on the GPU (created or grown as needed, pboBytes tracks its size) and only the
+// N layers asked for are mapped and copied out; GL_PACK_ALIGNMENT as set by the caller
+void ReadTextureLayers(GLuint texture, GLenum format, GLenum type, size_t layerBytes, int N, int layers,
+                       GLuint& pbo, size_t& pboBytes, void* out);
+
+class Framebuffer
+{
+public:
+    Framebuffer();
+
+    // allocate color/depth storage of the requested size (returns false on an incomplete FBO);
+    // colorFormat GL_RGBA16F keeps values above 1 for the sensor model (see SensorSettings)
+    bool Create(int width, int height, GLenum colorFormat = GL_RGBA8);
+
+    // color stored as a 2D texture array with one layer per frame, depth shared across layers
+    bool CreateLayered(int width, int height, int layers, GLenum colorFormat = GL_RGBA8);
+    void Delete();
+
+    // make this the draw/read target and match the viewport to it
+    void Bind();
+    void BindLayer(int layer);
+    static void Unbind();
+
+    // read the first N layers into one contiguous buffer (N * width * height * 3 bytes, bottom-up rows)
+    void ReadLayersRGB(int N, unsigned char* out);
+
+    // same with 1 (red only) or 3 channels per pixel
+    void ReadLayers(int N, int channels, unsigned char* out);
+
+    int m_width;
+    int m_height;
+    int m_layers;                   // 0 for a plain renderbuffer target
+    GLenum m_colorFormat;
+    GLuint m_fbo;
+    GLuint m_color;
+    GLuint m_depth;
+    GLuint m_pbo;                   // partial batch readback (see ReadTextureLayers)
+    size_t m_pboBytes;
+    bool m_initialized;
+};
+
+#endif
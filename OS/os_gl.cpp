@@ -10,6 +10,15 @@
 // ------------------------------------------------------------------------
 
 #include "os_gl.hpp"
+#include "os_assetloader.hpp"
+#include "os_labels.hpp"
+#include "os_postprocess.hpp"
+#include "os_profiler.hpp"
+#include "os_renderstate.hpp"
+#include "os_shadowmap.hpp"
+#include "os_softraster.hpp"
+#include "os_starpsf.hpp"
+#include "os_tiling.hpp"
 //#include "mex.h"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -18,6 +27,9 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "include/stb/stb_image_write.h"
 
+#include <cfloat>
+#include <cstring>
+
 void CallbackFrameBufferSize(GLFWwindow* window, int width, int height);
 void CallbackMouse(GLFWwindow* window, double xpos, double ypos);
 void CallbackScroll(GLFWwindow* window, double xoffset, double yoffset);
@@ -33,17 +45,48 @@ bool mouse_input = false;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
-// global buffers
-const int BUFFER_SIZE_VERTEX = 100000;
-const int BUFFER_SIZE_PARTS = 1000;
-
 GL::GL()
 {
+    m_headless = false;
+    m_quantizeNormals = false;
+    m_meshCache = true;
+    m_lodLevels = 4;
+    m_lodPixelError = 0.5f;
+    m_batchLayer = 0;
+    m_labelsOn = false;
+    m_tileSize = 0;
+    m_tileOn = false;
+    m_software = false;
+    m_starSigma = 0.7f;
+    m_shadowSize = 2048;
+    m_shadowedDraws = 0;
+    m_writeFailures = 0;
+    m_sensorFrame = 0;
+    m_sensorStride = 1;
     m_camera = Camera(glm::vec3(0.0f, 0.0f, 3.0f));
 }
 
-GL::GL(int Nu, int Nv, double ppx, double ppy, double fx, double fy){
+// software: no GL context at all, frames come from the CPU rasterizer (implies headless)
+GL::GL(int Nu, int Nv, double ppx, double ppy, double fx, double fy, bool headless, bool software){
     mouse_input = false;
+    m_headless = headless;
+    m_quantizeNormals = false;
+    m_meshCache = true;
+    m_lodLevels = 4;
+    m_lodPixelError = 0.5f;
+    m_batchLayer = 0;
+    m_labelsOn = false;
+    m_tileSize = 0;
+    m_tileOn = false;
+    m_software = software;
+    if (m_software)
+        m_headless = true;
+    m_starSigma = 0.7f;
+    m_shadowSize = 2048;
+    m_shadowedDraws = 0;
+    m_writeFailures = 0;
+    m_sensorFrame = 0;
+    m_sensorStride = 1;
     
     // camera properties
     m_camera = Camera(glm::vec3(0.0f, 0.0f, 3.0f));
@@ -70,7 +113,26 @@ GL::~GL()
     DeleteCAD(m_triad);
     DeleteCAD(m_cube);
 
-    glfwTerminate();
+    DrainScreenshots();
+    m_writer.Join();
+    m_profiler.DeleteQueries();
+    m_starField.Delete();
+    m_starSplat.Delete();
+    DeleteShadowMaps();
+    m_renderState.Delete();
+    m_readback.Delete();
+    m_batchFbo.Delete();
+    m_outputFbo.Delete();
+    m_postSource.Delete();
+    m_postProcess.Delete();
+    m_labels.Delete();
+    m_tileFbo.Delete();
+    if (m_headless){
+        m_fbo.Delete();
+        m_context.Destroy();
+    }
+    else
+        glfwTerminate();
 }
 
 void GL::Terminate(){
@@ -78,6 +140,33 @@ void GL::Terminate(){
 }
 
 int GL::Create_Window(){
+    // GL objects do not survive the old context
+    DrainScreenshots();
+    m_profiler.DeleteQueries();
+    m_starField.Delete();
+    m_starSplat.Delete();
+    DeleteShadowMaps();
+    m_renderState.Delete();
+    m_readback.Delete();
+    m_batchFbo.Delete();
+    m_outputFbo.Delete();
+    m_postSource.Delete();
+    m_postProcess.Delete();
+    m_labels.Delete();
+    m_tileFbo.Delete();
+
+    // no GL at all: nothing to time on a GPU, the rasterizer follows the camera size (see ClearScreen)
+    if (m_software){
+        m_profiler.EnableGPU(false);
+        m_soft.Start(0);
+        std::cout << "Software renderer, " << std::max(1u, std::thread::hardware_concurrency()) << " threads" << std::endl;
+        return 0;
+    }
+
+    // no window at all, render into an offscreen framebuffer
+    if (m_headless)
+        return Create_Offscreen();
+
     // kill any old windows
     glfwTerminate();
     
@@ -135,27 +224,79 @@ int GL::Create_Window(){
     return 0;
 }
 
+int GL::Create_Offscreen(){
+    // tear down any previous context
+    m_fbo.Delete();
+    m_context.Destroy();
+    m_window = NULL;
+
+    if (!m_context.Create(3, 3)){
+        std::cout << "Failed to create headless OpenGL context" << std::endl;
+        return -1;
+    }
+
+    // all rendering goes into a camera-sized framebuffer object; frames beyond the
+    // renderbuffer / viewport limits are rendered in tiles (see BeginTile)
+    GLint maxRenderbuffer, maxViewport[2];
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    int maxWidth = std::min((int) maxRenderbuffer, (int) maxViewport[0]);
+    int maxHeight = std::min((int) maxRenderbuffer, (int) maxViewport[1]);
+    if ((m_camera.Nu > maxWidth || m_camera.Nv > maxHeight) && m_tileSize == 0){
+        const int DEFAULT_TILE_SIZE = 2048;
+        m_tileSize = std::min(DEFAULT_TILE_SIZE, std::min(maxWidth, maxHeight));
+        std::cout << "Frame " << m_camera.Nu << "x" << m_camera.Nv << " exceeds the framebuffer limits, rendering in "
+                  << m_tileSize << " pixel tiles" << std::endl;
+    }
+    if (!m_fbo.Create(std::min(m_camera.Nu, maxWidth), std::min(m_camera.Nv, maxHeight))){
+        std::cout << "Failed to create offscreen framebuffer" << std::endl;
+        m_context.Destroy();
+        return -1;
+    }
+
+    // configure global opengl state
+    glEnable(GL_DEPTH_TEST);
+
+    return 0;
+}
+
 void GL::MaximizeWindow(){
+    if (m_headless)
+        return;
     glfwMaximizeWindow(m_window);
 }
 
 void GL::SetDecorator(bool decoratorOn){
     m_decoratorOn = decoratorOn;
+    if (m_headless)
+        return;
     Create_Window();
 }
 
 void GL::SetWindowPosition(int xPos, int yPos){
     m_windowPosX = xPos;
     m_windowPosY = yPos;
+    if (m_headless)
+        return;
     glfwSetWindowPos(m_window, m_windowPosX, m_windowPosY);
 }
 
 void GL::GetWindowSize(int* outWidth, int* outHeight){
+    if (m_headless){
+        *outWidth = m_camera.Nu;
+        *outHeight = m_camera.Nv;
+        return;
+    }
     glfwGetWindowSize(m_window, outWidth, outHeight);
 }
 
 void GL::GetMonitorSize(int* widthPIX, int* heightPIX){
     GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    if (monitor == NULL){
+        *widthPIX = 0;
+        *heightPIX = 0;
+        return;
+    }
     const GLFWvidmode* mode = glfwGetVideoMode(monitor);
     *widthPIX = mode->width;
     *heightPIX = mode->height;
@@ -163,36 +304,221 @@ void GL::GetMonitorSize(int* widthPIX, int* heightPIX){
 
 void GL::GetMonitorPhysicalSize(int* widthMM, int* heightMM){
     GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    if (monitor == NULL){
+        *widthMM = 0;
+        *heightMM = 0;
+        return;
+    }
     glfwGetMonitorPhysicalSize(monitor, widthMM, heightMM);
 }
 
 void GL::ClearScreen(){
+    ProfileScope profile(m_profiler, Profiler::STAGE_CLEAR, true);
+
+    // software renderer: a new list of draws, shaded with this frame's camera and lights
+    if (m_software){
+        if (!m_tileOn && (m_soft.m_width != m_camera.Nu || m_soft.m_height != m_camera.Nv))
+            m_soft.Resize(m_camera.Nu, m_camera.Nv);
+        m_soft.Clear();
+
+        // same lights as FragmentShader (the lamp takes the sun's slot)
+        std::vector<SoftLight> lights;
+        CAD* sources[2] = {(m_lamp.initialized && m_lamp.on) ? &m_lamp : &m_sun, &m_moon};
+        for (CAD* source : sources){
+            if (!source->initialized || !source->on)
+                continue;
+            glm::vec3 r_Go2Lo_gl = glm::normalize(VBS2GL(source->r_vbs));
+            SoftLight light = {{r_Go2Lo_gl.x, r_Go2Lo_gl.y, r_Go2Lo_gl.z}, 0.05f, 0.4f, 0.5f};
+            lights.push_back(light);
+        }
+        glm::mat4 view = m_camera.GetViewMatrix();
+        float eye[3] = {m_camera.Position.x, m_camera.Position.y, m_camera.Position.z};
+        m_soft.SetFrame(&view[0][0], eye, lights, 32.0f);
+        return;
+    }
+
     // clear the buffer array to prepare a new screen
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+    // label layer of the same frame
+    if (m_labelsOn && !m_tileOn){
+        if (!m_labels.m_initialized || m_labels.m_width != m_camera.Nu || m_labels.m_height != m_camera.Nv ||
+            m_labels.m_layers <= m_batchLayer){
+            if (!m_labels.Create(m_camera.Nu, m_camera.Nv, std::max(1, m_batchFbo.m_layers)))
+                throw std::runtime_error("Could not allocate label framebuffer\n");
+        }
+        m_labels.ClearLayer(m_batchLayer);
+    }
+
+    // anything may have rebound programs / textures since the last frame
+    m_renderState.Invalidate();
 }
 
 void GL::SwapBuffers(){
-    // clear the buffer array to prepare a new screen
-    glfwSwapBuffers(m_window);
+    {
+        ProfileScope profile(m_profiler, Profiler::STAGE_SWAP);
+
+        // headless: nothing to present, just submit the queued commands
+        if (m_software)
+            m_soft.Resolve();
+        else if (m_headless)
+            glFlush();
+        else
+            glfwSwapBuffers(m_window);
+    }
+
+    // timer queries of earlier frames that have landed by now
+    m_profiler.CollectGPU(false);
+}
+
+void GL::SetProfiling(bool profilingOn){
+    m_profiler.Reset();
+    m_profiler.Enable(profilingOn);
+}
+
+bool GL::SaveProfile(const std::string& prefix){
+
+    // every frame encoded and every query landed before the numbers are final
+    DrainScreenshots();
+    m_profiler.CollectGPU(true);
+    m_profiler.Print();
+    return m_profiler.WriteJSON(prefix + ".json") && m_profiler.WriteChromeTrace(prefix + ".trace.json");
 }
 
 void GL::Screenshot(std::string filename) {
 
-    // read pixels
-    char *pixel_data = new char[3*m_camera.Nu*m_camera.Nv];
-    glReadBuffer(GL_FRONT);
-    glReadPixels(0, 0, m_camera.Nu, m_camera.Nv, GL_RGB, GL_UNSIGNED_BYTE, pixel_data);
-    
+    // software renderer: the frame is already in memory, straight to the encoder pool
+    if (m_software){
+        ProfileScope profile(m_profiler, Profiler::STAGE_READBACK);
+        ReadbackFrame frame;
+        frame.filename = filename;
+        frame.width = OutputWidth();
+        frame.height = OutputHeight();
+        frame.channels = OutputChannels();
+        frame.pixels = m_readback.m_pool.Acquire((size_t) frame.channels * frame.width * frame.height);
+        SoftOutput(0, frame.pixels.data());
+        m_sensorFrame += m_sensorStride;
+        WriteFrame(frame);
+        return;
+    }
+
+    // (re)allocate the pixel pack ring when the output size changes
+    const int READBACK_DEPTH = 3;
+    if (!m_readback.m_initialized || m_readback.m_width != OutputWidth() || m_readback.m_height != OutputHeight() ||
+        m_readback.m_channels != OutputChannels()){
+        DrainScreenshots();
+        m_readback.Create(OutputWidth(), OutputHeight(), READBACK_DEPTH, OutputChannels());
+    }
+
+    ProfileScope profile(m_profiler, Profiler::STAGE_READBACK);
+
+    // make room for this frame
+    ReadbackFrame frame;
+    if (m_readback.Full() && m_readback.CollectOldest(frame, true))
+        WriteFrame(frame);
+
+    // queue the transfer, the pixels are written once the GPU is done with them
+    if (m_headless)
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+    else
+        glReadBuffer(GL_FRONT);
+    if (OutputPostProcess()){
+        // the frame is copied into a texture, post-processed into the output target and read from there
+        if (!m_postSource.m_initialized || m_postSource.m_width != m_camera.Nu || m_postSource.m_height != m_camera.Nv ||
+            m_postSource.m_colorFormat != RenderFormat()){
+            GLint readFbo;
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+            if (!m_postSource.CreateLayered(m_camera.Nu, m_camera.Nv, 1, RenderFormat()))
+                throw std::runtime_error("Could not allocate post-process source\n");
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+        }
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_postSource.m_fbo);
+        glBlitFramebuffer(0, 0, m_camera.Nu, m_camera.Nv, 0, 0, m_camera.Nu, m_camera.Nv, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        float region[4];
+        OutputRegion(0, region);
+        AllocateOutput(1);
+        m_postProcess.Run(m_postSource.m_color, 0, m_camera.Nu, m_camera.Nv, region, m_output.luma, m_outputFbo, 0,
+                          m_sensor, FocalPixels(), SensorKey(0));
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        m_readback.Request(filename);
+        m_renderState.Invalidate();
+
+        // restore the regular render target
+        if (m_headless)
+            m_fbo.Bind();
+        else{
+            Framebuffer::Unbind();
+            glViewport(0, 0, m_camera.Nu, m_camera.Nv);
+        }
+    }
+    else
+        m_readback.Request(filename);
+    m_sensorFrame += m_sensorStride;
+
+    // write any earlier frames that have already landed
+    while (m_readback.CollectOldest(frame, false))
+        WriteFrame(frame);
+}
+
+// false when any frame since the last call failed to encode or write
+bool GL::FlushScreenshots() {
+    DrainScreenshots();
+    bool ok = (m_writeFailures == 0);
+    m_writeFailures = 0;
+    return ok;
+}
+
+// write out every outstanding frame, failures accumulate until FlushScreenshots reports them
+void GL::DrainScreenshots() {
+    ReadbackFrame frame;
+    while (m_readback.Pending() > 0){
+        if (m_readback.CollectOldest(frame, true))
+            WriteFrame(frame);
+    }
+    m_writeFailures += m_writer.Flush();
+}
+
+void GL::WriteFrame(ReadbackFrame& frame) {
+
+    // encoding runs on a pool of worker threads, one core is left for rendering
+    if (!m_writer.m_running){
+        int nThreads = std::max(1, (int) std::thread::hardware_concurrency() - 1);
+        m_writer.Start(nThreads, 2*nThreads, [this](ReadbackFrame& job){
+            int status = WriteImage(job.filename, (const char*) job.pixels.data(), job.width, job.height, job.channels);
+            m_readback.m_pool.Release(std::move(job.pixels));
+            return status != 0;
+        });
+    }
+
+    // hand the buffer to the encoder pool (blocks while it is saturated)
+    m_writer.Submit(std::move(frame));
+}
+
+int GL::WriteImage(const std::string& filename, const char* pixel_data, int width, int height, int channels) {
+
     // detect file type
     std::string imageType = filename.substr(filename.length()-3, filename.length());
     std::transform(imageType.begin(), imageType.end(), imageType.begin(), ::tolower);
     
-    // write to file
-    int status;
-    int stride_bytes = 3*m_camera.Nu*sizeof(pixel_data[0]);
-
-    switch( m_mapImageType[imageType] )
+    // find() rather than operator[]: this runs concurrently on the encoder threads
+    auto it = m_mapImageType.find(imageType);
+    GL::IMAGE_TYPES type = (it == m_mapImageType.end()) ? GL::IMAGE_TYPES::INVALID : it->second;
+
+    // encode into memory, then write to file (timed as separate stages)
+    static thread_local std::vector<unsigned char> encoded;
+    encoded.clear();
+    auto Append = [](void* context, void* data, int size){
+        std::vector<unsigned char>* out = (std::vector<unsigned char>*) context;
+        out->insert(out->end(), (unsigned char*) data, (unsigned char*) data + size);
+    };
+    Profiler::Clock::time_point t0 = Profiler::Now();
+
+    int status = 0;
+    int stride_bytes = channels*width*sizeof(pixel_data[0]);
+
+    switch( type )
     {
         case GL::IMAGE_TYPES::INVALID :
         {
@@ -201,22 +527,22 @@ void GL::Screenshot(std::string filename) {
         }
         case GL::IMAGE_TYPES::PNG :
         {
-            status = stbi_write_png(filename.c_str(), m_camera.Nu, m_camera.Nv, 3, pixel_data, stride_bytes);
+            status = stbi_write_png_to_func(Append, &encoded, width, height, channels, pixel_data, stride_bytes);
             break;   
         }
         case GL::IMAGE_TYPES::JPG :
         {
-            status = stbi_write_jpg(filename.c_str(), m_camera.Nu, m_camera.Nv, 3, pixel_data, stride_bytes);
+            status = stbi_write_jpg_to_func(Append, &encoded, width, height, channels, pixel_data, stride_bytes);
             break;   
         }
         case GL::IMAGE_TYPES::BMP :
         {
-            status = stbi_write_bmp(filename.c_str(), m_camera.Nu, m_camera.Nv, 3, pixel_data);
+            status = stbi_write_bmp_to_func(Append, &encoded, width, height, channels, pixel_data);
             break;   
         }
         case GL::IMAGE_TYPES::TGA :
         {
-            status = stbi_write_tga(filename.c_str(), m_camera.Nu, m_camera.Nv, 3, pixel_data);
+            status = stbi_write_tga_to_func(Append, &encoded, width, height, channels, pixel_data);
             break;   
         }
         default:{
@@ -224,100 +550,387 @@ void GL::Screenshot(std::string filename) {
             break;
         }
     }
-    delete[] pixel_data;
+    if (status == 0)
+        return status;
+
+    Profiler::Clock::time_point t1 = Profiler::Now();
+    m_profiler.RecordCPU(Profiler::STAGE_ENCODE, t0, t1);
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    status = (file != NULL) && fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    if (file != NULL)
+        status = (fclose(file) == 0) && status;
+    m_profiler.RecordCPU(Profiler::STAGE_WRITE, t1, Profiler::Now());
+    return status;
 }
 
-void GL::SetAlphaNearFarPlane(float alpha){
-    alphaNearFarPlane = alpha;
+int GL::BeginBatch(int N){
+
+    // cap the layered target so a batch stays within the GPU memory budget
+    const size_t BATCH_BUDGET_BYTES = 512u * 1024u * 1024u;
+    // colour is RGBA8, or RGBA16F with the sensor model on; labels add mask, depth and a depth buffer
+    size_t colorBytes = (RenderFormat() == GL_RGBA16F) ? 8 : 4;
+    size_t frameBytes = (colorBytes + (m_labelsOn ? 2 + 4 + 4 : 0)) * m_camera.Nu * m_camera.Nv;
+
+    // software renderer: only the output frames are held until EndBatch
+    if (m_software){
+        size_t outputBytes = (size_t) OutputChannels() * OutputWidth() * OutputHeight();
+        int capacity = (int) std::min<size_t>(N, std::max<size_t>(1, BATCH_BUDGET_BYTES / outputBytes));
+        m_softBatch.resize(capacity * outputBytes);
+        return capacity;
+    }
+
+    GLint maxLayers;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    int capacity = (int) std::max<size_t>(1, BATCH_BUDGET_BYTES / frameBytes);
+    capacity = std::min(capacity, (int) maxLayers);
+    capacity = std::min(capacity, N);
+
+    // reuse the previous allocation when it is large enough
+    if (!m_batchFbo.m_initialized || m_batchFbo.m_layers < capacity ||
+        m_batchFbo.m_width != m_camera.Nu || m_batchFbo.m_height != m_camera.Nv || m_batchFbo.m_colorFormat != RenderFormat()){
+        if (!m_batchFbo.CreateLayered(m_camera.Nu, m_camera.Nv, capacity, RenderFormat()))
+            throw std::runtime_error("Could not allocate batch framebuffer\n");
+    }
+
+    if (m_labelsOn && (!m_labels.m_initialized || m_labels.m_layers < m_batchFbo.m_layers ||
+                       m_labels.m_width != m_camera.Nu || m_labels.m_height != m_camera.Nv)){
+        if (!m_labels.Create(m_camera.Nu, m_camera.Nv, m_batchFbo.m_layers))
+            throw std::runtime_error("Could not allocate label framebuffer\n");
+    }
+
+    return std::min(m_batchFbo.m_layers, N);
 }
 
-// utility function for loading a 2D texture from file
-unsigned int GL::LoadTexture(char const * path){
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+void GL::SetTileSize(int tileSize){
+    m_tileSize = std::max(0, tileSize);
+}
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+bool GL::Tiled(){
+    return m_tileSize > 0;
+}
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+int GL::TileSize(){
+    return m_tileSize > 0 ? m_tileSize : std::max(m_camera.Nu, m_camera.Nv);
+}
+
+void GL::BeginTile(const Tile& tile){
+
+    if (m_software){
+        m_tile = tile;
+        m_tileOn = true;
+        m_soft.Resize(tile.width, tile.height);
+        return;
+    }
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (!m_tileFbo.m_initialized || m_tileFbo.m_width != TileSize() || m_tileFbo.m_height != TileSize()){
+        if (!m_tileFbo.Create(TileSize(), TileSize()))
+            throw std::runtime_error("Could not allocate tile framebuffer\n");
+    }
+
+    // draws go through the tile's sub-frustum onto the tile's corner of the target
+    m_tile = tile;
+    m_tileOn = true;
+    m_tileFbo.Bind();
+    glViewport(0, 0, tile.width, tile.height);
+}
 
-        stbi_image_free(data);
+void GL::EndTile(unsigned char* pixels){
+
+    ProfileScope profile(m_profiler, Profiler::STAGE_READBACK);
+    if (m_software){
+        m_soft.Resolve();
+        std::memcpy(pixels, m_soft.Pixels(), (size_t) 3 * m_tile.width * m_tile.height);
+        m_tileOn = false;
+        return;
     }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_tileFbo.m_fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_tile.width, m_tile.height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    m_tileOn = false;
+
+    // restore the regular render target
+    if (m_headless)
+        m_fbo.Bind();
+    else{
+        Framebuffer::Unbind();
+        glViewport(0, 0, m_camera.Nu, m_camera.Nv);
+    }
+}
+
+void GL::SetLabels(bool labelsOn){
+    if (labelsOn && m_software){
+        std::cout << "Labels are not rendered by the software renderer" << std::endl;
+        labelsOn = false;
+    }
+    m_labelsOn = labelsOn;
+    if (!labelsOn)
+        m_labels.Delete();
+}
+
+void GL::ReadLabels(){
+    size_t framePixels = (size_t) m_camera.Nu * m_camera.Nv;
+    m_labelMask.resize(framePixels);
+    m_labelDepth.resize(framePixels);
+    if (m_labels.m_initialized)
+        m_labels.ReadLayers(1, m_labelMask.data(), m_labelDepth.data());
+}
+
+void GL::SetOutputSize(int width, int height){
+    m_output.width = std::max(0, width);
+    m_output.height = std::max(0, height);
+}
+
+void GL::SetOutputLuma(bool lumaOn){
+    m_output.luma = lumaOn;
+}
+
+void GL::SetOutputROI(bool roiOn, float margin){
+    m_output.roi = roiOn;
+    m_output.roiMargin = std::max(0.0f, margin);
+}
+
+int GL::OutputWidth(){
+    return (m_output.width > 0 && m_output.height > 0) ? m_output.width : m_camera.Nu;
+}
+
+int GL::OutputHeight(){
+    return (m_output.width > 0 && m_output.height > 0) ? m_output.height : m_camera.Nv;
+}
+
+int GL::OutputChannels(){
+    return m_output.luma ? 1 : 3;
+}
+
+bool GL::OutputPostProcess(){
+    return OutputWidth() != m_camera.Nu || OutputHeight() != m_camera.Nv || m_output.luma || m_output.roi || m_sensor.on;
+}
+
+void GL::SetSensor(const SensorSettings& sensor){
+
+    m_sensor = sensor;
+    m_sensor.bits = std::min(8, std::max(1, sensor.bits));
+
+    // the headless target holds the linear signal above 1 (a window keeps its 8-bit back buffer)
+    if (m_headless && !m_software && m_fbo.m_initialized && m_fbo.m_colorFormat != RenderFormat()){
+        if (!m_fbo.Create(m_fbo.m_width, m_fbo.m_height, RenderFormat()))
+            throw std::runtime_error("Could not allocate the sensor model render target\n");
+    }
+}
+
+void GL::SetSensorFrames(unsigned int first, unsigned int stride){
+    m_sensorFrame = first;
+    m_sensorStride = stride;
+}
+
+unsigned int GL::SensorKey(int layer){
+    return m_sensorFrame + m_sensorStride * (unsigned int) layer;
+}
+
+GLenum GL::RenderFormat(){
+    return m_sensor.on ? GL_RGBA16F : GL_RGBA8;
+}
+
+float GL::FocalPixels(){
+    return (float) (m_camera.fx / m_camera.dx);
+}
+
+static glm::mat4 Perspective(const Camera& camera, float d_near_gl, float d_far_gl);
+
+bool GL::ProjectedBounds(CAD& cad, float box[4]){
+
+    if (cad.initialized == false || cad.mesh.m_bounds.empty())
+        return false;
+
+    // box of the whole assembly from the per-part boxes
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t k = 0; k < cad.mesh.m_count.size(); k++){
+        if (cad.mesh.m_count[k] == 0)
+            continue;
+        for (int c = 0; c < 3; c++){
+            lo[c] = std::min(lo[c], cad.mesh.m_bounds[6*k + c]);
+            hi[c] = std::max(hi[c], cad.mesh.m_bounds[6*k + 3 + c]);
+        }
+    }
+    if (lo[0] > hi[0])
+        return false;
+
+    float d_near_vbs = Norm(cad.r_vbs) - alphaNearFarPlane*cad.scale;
+    glm::mat4 clip = Perspective(m_camera, d_near_vbs, d_near_vbs + 2*alphaNearFarPlane*cad.scale) *
+                     m_camera.GetViewMatrix() * ModelMatrix(cad);
+
+    // corners to window coordinates; a corner behind the camera makes the box unbounded
+    box[0] = box[1] = FLT_MAX;
+    box[2] = box[3] = -FLT_MAX;
+    for (int corner = 0; corner < 8; corner++){
+        glm::vec4 p(corner & 1 ? hi[0] : lo[0], corner & 2 ? hi[1] : lo[1], corner & 4 ? hi[2] : lo[2], 1.0f);
+        glm::vec4 q = clip * p;
+        if (q.w <= 0.0f)
+            return false;
+        float u = (0.5f * q.x / q.w + 0.5f) * m_camera.Nu;
+        float v = (0.5f * q.y / q.w + 0.5f) * m_camera.Nv;
+        box[0] = std::min(box[0], u);
+        box[1] = std::min(box[1], v);
+        box[2] = std::max(box[2], u);
+        box[3] = std::max(box[3], v);
+    }
+    return true;
+}
+
+void GL::MarkROI(CAD& cad){
+
+    if (!m_output.roi)
+        return;
+    if (m_frameBoxes.size() < 4*(size_t) (m_batchLayer + 1))
+        m_frameBoxes.resize(4*(m_batchLayer + 1));
+
+    // nothing to crop to (not loaded, off screen behind the camera): the whole frame
+    float* box = &m_frameBoxes[4*m_batchLayer];
+    if (!ProjectedBounds(cad, box)){
+        box[0] = box[1] = 0.0f;
+        box[2] = (float) m_camera.Nu;
+        box[3] = (float) m_camera.Nv;
+    }
+}
+
+void GL::OutputRegion(int layer, float region[4]){
+    if (m_output.roi && m_frameBoxes.size() >= 4*(size_t) (layer + 1))
+        PostProcess::BoxRegion(&m_frameBoxes[4*layer], m_output.roiMargin, OutputWidth(), OutputHeight(), region);
     else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+        PostProcess::FrameRegion(m_camera.Nu, m_camera.Nv, OutputWidth(), OutputHeight(), region);
+}
+
+void GL::AllocateOutput(int layers){
+    if (!m_outputFbo.m_initialized || m_outputFbo.m_layers < layers ||
+        m_outputFbo.m_width != OutputWidth() || m_outputFbo.m_height != OutputHeight()){
+        if (!m_outputFbo.CreateLayered(OutputWidth(), OutputHeight(), layers))
+            throw std::runtime_error("Could not allocate output framebuffer\n");
     }
+}
 
-    return textureID;
+// resolved software frame into the output format of one batch layer (or of Screenshot, layer 0)
+void GL::SoftOutput(int layer, unsigned char* out){
+
+    m_soft.Resolve();
+    if (!OutputPostProcess()){
+        std::memcpy(out, m_soft.Pixels(), (size_t) 3 * m_camera.Nu * m_camera.Nv);
+        return;
+    }
+    float region[4];
+    OutputRegion(layer, region);
+    PostProcess::RunCPU(m_soft.Pixels(), m_camera.Nu, m_camera.Nv, region, m_output.luma,
+                        OutputWidth(), OutputHeight(), out, m_sensor, FocalPixels(), SensorKey(layer));
 }
 
-float* GL::LoadSTL(cad::part part){
-    
-    float R = part.color.r;
-    float G = part.color.g;
-    float B = part.color.b;
+void GL::BeginBatchFrame(int layer){
+
+    // software renderer: the previous frame is done once the next one begins
+    if (m_software){
+        size_t outputBytes = (size_t) OutputChannels() * OutputWidth() * OutputHeight();
+        if (layer > 0)
+            SoftOutput(layer - 1, &m_softBatch[(layer - 1) * outputBytes]);
+        m_batchLayer = layer;
+        return;
+    }
+    m_batchLayer = layer;
+    m_batchFbo.BindLayer(layer);
+}
+
+void GL::EndBatch(int N, unsigned char* frames){
+
+    // one readback for every frame of the batch
+    ProfileScope profile(m_profiler, Profiler::STAGE_READBACK);
+    m_regions.resize(4*N);
+    if (m_software){
+        size_t outputBytes = (size_t) OutputChannels() * OutputWidth() * OutputHeight();
+        for (int i = 0; i < N; i++)
+            OutputRegion(i, &m_regions[4*i]);
+        SoftOutput(N - 1, &m_softBatch[(N - 1) * outputBytes]);
+        std::memcpy(frames, m_softBatch.data(), N * outputBytes);
+        m_sensorFrame += m_sensorStride * N;
+        m_batchLayer = 0;
+        return;
+    }
+    if (!OutputPostProcess()){
+        for (int i = 0; i < N; i++)
+            OutputRegion(i, &m_regions[4*i]);
+        m_batchFbo.ReadLayersRGB(N, frames);
+    }
+    else{
+        // resized / cropped / reduced on the GPU, only the small frames cross the bus
+        AllocateOutput(m_batchFbo.m_layers);
+        for (int i = 0; i < N; i++){
+            OutputRegion(i, &m_regions[4*i]);
+            m_postProcess.Run(m_batchFbo.m_color, i, m_camera.Nu, m_camera.Nv, &m_regions[4*i],
+                              m_output.luma, m_outputFbo, i, m_sensor, FocalPixels(), SensorKey(i));
+        }
+        m_outputFbo.ReadLayers(N, OutputChannels(), frames);
+        m_renderState.Invalidate();
+    }
+    if (m_labelsOn && m_labels.m_initialized){
+        size_t framePixels = (size_t) m_camera.Nu * m_camera.Nv;
+        m_labelMask.resize(N * framePixels);
+        m_labelDepth.resize(N * framePixels);
+        m_labels.ReadLayers(N, m_labelMask.data(), m_labelDepth.data());
+    }
+    m_sensorFrame += m_sensorStride * N;
+    m_batchLayer = 0;
+
+    // restore the regular render target
+    if (m_headless)
+        m_fbo.Bind();
+    else{
+        Framebuffer::Unbind();
+        glViewport(0, 0, m_camera.Nu, m_camera.Nv);
+    }
+}
+
+void GL::SetAlphaNearFarPlane(float alpha){
+    alphaNearFarPlane = alpha;
+}
+
+void GL::SetQuantizeNormals(bool quantizeNormals){
+    // applies to CAD models loaded afterwards
+    m_quantizeNormals = quantizeNormals;
+}
+
+void GL::SetLOD(int levels, float maxPixelError){
+    // levels: decimated copies built for CAD models loaded afterwards (0 = off)
+    // maxPixelError: largest projected vertex displacement a coarser level may introduce
+    m_lodLevels = levels;
+    m_lodPixelError = maxPixelError;
+}
+
+void GL::SetMeshCache(bool meshCacheOn){
+    // <root_dir><fn_csv>.osmc is read (and written on a miss) by LoadCAD / LoadTexturedSphere
+    m_meshCache = meshCacheOn;
+}
+
+// utility function for loading a 2D texture from file
+unsigned int GL::LoadTexture(char const * path){
+    TextureImage image;
+    DecodeTexture(path, image);
+    return UploadTexture(image);
+}
+
+void GL::LoadSTL(const cad::part& part, MeshBuilder& builder){
     
     float mm2m = 1.0f/1000.0f;  // convert STL from [mm] to [m]
     
-    // 3 triangles
-    // 9 attributes per triangle (xyz,normal,rgb)
-    float *verticies = new float[BUFFER_SIZE_VERTEX * 9 * 3];
-
-    int count = 0;
-    for (auto t : part.triangles){        
-        verticies[count +  0] = (float) t.v1.x * mm2m;
-        verticies[count +  1] = (float) t.v1.y * mm2m;
-        verticies[count +  2] = (float) t.v1.z * mm2m;
-        verticies[count +  3] = (float) t.normal.x;
-        verticies[count +  4] = (float) t.normal.y;
-        verticies[count +  5] = (float) t.normal.z;
-        verticies[count +  6] = R;
-        verticies[count +  7] = G;
-        verticies[count +  8] = B;
-                
-        count = count + 9;
-        verticies[count +  0] = (float) t.v2.x * mm2m;
-        verticies[count +  1] = (float) t.v2.y * mm2m;
-        verticies[count +  2] = (float) t.v2.z * mm2m;
-        verticies[count +  3] = (float) t.normal.x;
-        verticies[count +  4] = (float) t.normal.y;
-        verticies[count +  5] = (float) t.normal.z;
-        verticies[count +  6] = R;
-        verticies[count +  7] = G;
-        verticies[count +  8] = B;
-        
-        count = count + 9;
-        verticies[count +  0] = (float) t.v3.x * mm2m;
-        verticies[count +  1] = (float) t.v3.y * mm2m;
-        verticies[count +  2] = (float) t.v3.z * mm2m;
-        verticies[count +  3] = (float) t.normal.x;
-        verticies[count +  4] = (float) t.normal.y;
-        verticies[count +  5] = (float) t.normal.z;
-        verticies[count +  6] = R;
-        verticies[count +  7] = G;
-        verticies[count +  8] = B;
-        
-        count = count + 9;
+    // color is constant per part, shared vertices are welded by the builder
+    builder.BeginPart(part.color.r, part.color.g, part.color.b);
+    for (const auto& t : part.triangles){        
+        float n[3]  = {(float) t.normal.x, (float) t.normal.y, (float) t.normal.z};
+        float p1[3] = {(float) t.v1.x * mm2m, (float) t.v1.y * mm2m, (float) t.v1.z * mm2m};
+        float p2[3] = {(float) t.v2.x * mm2m, (float) t.v2.y * mm2m, (float) t.v2.z * mm2m};
+        float p3[3] = {(float) t.v3.x * mm2m, (float) t.v3.y * mm2m, (float) t.v3.z * mm2m};
+        builder.AddVertex(p1, n);
+        builder.AddVertex(p2, n);
+        builder.AddVertex(p3, n);
     }
-    
-    return verticies;
+    builder.EndPart();
 }
 
 CAD GL::LoadCAD(
@@ -327,70 +940,12 @@ CAD GL::LoadCAD(
         const std::string& fn_textureSpecular,
         float scale)
 {
-    
-    // load assembly
-    CAD foo;
-    try {
-        foo.assembly = cad::parse(fn_csv, root_dir);
-        foo.VAO = new GLuint[BUFFER_SIZE_PARTS];
-        foo.VBO = new GLuint[BUFFER_SIZE_PARTS];
-        foo.texture.diffuse = LoadTexture(fn_textureDiffuse.c_str());
-        foo.texture.specular = LoadTexture(fn_textureSpecular.c_str());
-        foo.r_vbs = Vector(3);
-        foo.q_vbs2body = Vector(4);
-        foo.q_vbs2body(0) = 1;
-        foo.scale = scale;
-        foo.initialized = true;
-    }catch (...){
-        std::cout << "Error parsing CSV: "<< std::string( root_dir + fn_csv ) << std::endl;
-        throw std::runtime_error("Could not read CSV\n");
-        return foo;
-    }
-    int N_parts = foo.assembly.parts.size();
-    
-    //printf("N_parts = %d\n", N_parts);
-    
-    int total_triangles = 0;
-    
-    // first, configure the cube's VAO (and VBO_parts)
-    glGenVertexArrays(BUFFER_SIZE_PARTS, foo.VAO);
-    glGenBuffers(BUFFER_SIZE_PARTS, foo.VBO);
-
-    float* vertices;
-    int count = 0;
-    for (auto part : foo.assembly.parts){
-        // determine number of triangles are in part
-        vertices = LoadSTL( part );
-        int N = part.triangles.size();
-        
-        // load data into buffer
-        glBindBuffer(GL_ARRAY_BUFFER, foo.VBO[count]);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float)*27*N, vertices, GL_STATIC_DRAW);
-
-        // specify format [position, normals, rgb]
-        float STRIDE = (3 + 3 + 3) * sizeof(float);
-        glBindVertexArray(foo.VAO[count]);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)(6 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-                
-        count++;
-        
-        delete[] vertices;
-        
-        total_triangles = total_triangles + N;
-        
-        if( count == N_parts )
-            break;
-    }
-
-    //printf("total_triangles = %d\n", total_triangles);
-    
-    return foo;    
+    // parts are built and textures decoded in parallel, see AssetLoader for several assets at once
+    AssetLoader loader(*this);
+    loader.AddCAD(root_dir, fn_csv, fn_textureDiffuse, fn_textureSpecular, scale);
+    return loader.Load(0)[0];
 }
+
 CAD GL::LoadTexturedSphere(
         const std::string& root_dir, 
         const std::string& fn_csv, 
@@ -398,119 +953,22 @@ CAD GL::LoadTexturedSphere(
         const std::string& fn_textureSpecular,
         float scale)
 {    
-    // load assembly
-    CAD foo;
-    try {
-        foo.assembly = cad::parse(fn_csv, root_dir);
-        foo.VAO = new GLuint[BUFFER_SIZE_PARTS];
-        foo.VBO = new GLuint[BUFFER_SIZE_PARTS];
-        foo.texture.diffuse = LoadTexture(fn_textureDiffuse.c_str());
-        foo.texture.specular = LoadTexture(fn_textureSpecular.c_str());
-        foo.r_vbs = Vector(3);
-        foo.q_vbs2body = Vector(4);
-        foo.q_vbs2body(0) = 1;
-        foo.scale = scale;
-        foo.initialized = true;
-    }catch (...){
-        std::cout << "Error parsing CSV: "<< std::string( root_dir + fn_csv ) << std::endl;
-        throw std::runtime_error("Could not read CSV\n");
-        return foo;
-    }
-    int N_parts = foo.assembly.parts.size();
-    
-    // first, configure the cube's VAO (and VBO_parts)
-    glGenVertexArrays(BUFFER_SIZE_PARTS, foo.VAO);
-    glGenBuffers(BUFFER_SIZE_PARTS, foo.VBO);
-    
-    // 3 triangles
-    // 8 attributes per triangle (xyz,normal,uv)
-    float vertices[BUFFER_SIZE_VERTEX * 8 * 3];
-    int count = 0;
-    for (auto part : foo.assembly.parts){
-
-        // determine number of triangles are in part
-        float mm2m = 1.0f/1000.0f;  // convert STL from [mm] to [m]
-        float epsilon = 1e-1;
-        float latitude, longitude, xy_norm, u, v;
-        int count_triangles = 0;
-        for (auto t : part.triangles){        
-            
-            //mexPrintf("count_triangles = %05d / %05d = %f\n", count_triangles, BUFFER_SIZE_VERTEX, count_triangles*100.0/BUFFER_SIZE_VERTEX );
-            // avoid singularity
-            t.v1.x += epsilon; t.v1.y += epsilon; t.v1.z += epsilon;
-            t.v2.x += epsilon; t.v2.y += epsilon; t.v2.z += epsilon;
-            t.v3.x += epsilon; t.v3.y += epsilon; t.v3.z += epsilon;
-            
-            vertices[count_triangles +  0] = (float) t.v1.x * mm2m;
-            vertices[count_triangles +  1] = (float) t.v1.y * mm2m;
-            vertices[count_triangles +  2] = (float) t.v1.z * mm2m;
-            vertices[count_triangles +  3] = (float) t.normal.x;
-            vertices[count_triangles +  4] = (float) t.normal.y;
-            vertices[count_triangles +  5] = (float) t.normal.z;
-            xy_norm = sqrt(t.v1.x*t.v1.x + t.v1.y*t.v1.y);
-            latitude = std::atan2(t.v1.z, xy_norm) * RAD2DEG;
-            longitude = std::atan2(t.v1.y, t.v1.x) * RAD2DEG;
-            v = 0.5 - latitude/180.0;
-            u = longitude/360.0 + 0.5;
-            vertices[count_triangles +  6] = u;
-            vertices[count_triangles +  7] = v;
-
-            count_triangles = count_triangles + 8;
-            vertices[count_triangles +  0] = (float) t.v2.x * mm2m;
-            vertices[count_triangles +  1] = (float) t.v2.y * mm2m;
-            vertices[count_triangles +  2] = (float) t.v2.z * mm2m;
-            vertices[count_triangles +  3] = (float) t.normal.x;
-            vertices[count_triangles +  4] = (float) t.normal.y;
-            vertices[count_triangles +  5] = (float) t.normal.z;
-            xy_norm = sqrt(t.v2.x*t.v2.x + t.v2.y*t.v2.y);
-            latitude = std::atan2(t.v2.z, xy_norm) * RAD2DEG;
-            longitude = std::atan2(t.v2.y, t.v2.x) * RAD2DEG;
-            v = 0.5 - latitude/180.0;
-            u = longitude/360.0 + 0.5;
-            vertices[count_triangles +  6] = u;
-            vertices[count_triangles +  7] = v;
-
-            count_triangles = count_triangles + 8;
-            vertices[count_triangles +  0] = (float) t.v3.x * mm2m;
-            vertices[count_triangles +  1] = (float) t.v3.y * mm2m;
-            vertices[count_triangles +  2] = (float) t.v3.z * mm2m;
-            vertices[count_triangles +  3] = (float) t.normal.x;
-            vertices[count_triangles +  4] = (float) t.normal.y;
-            vertices[count_triangles +  5] = (float) t.normal.z;
-            xy_norm = sqrt(t.v3.x*t.v3.x + t.v3.y*t.v3.y);
-            latitude = std::atan2(t.v3.z, xy_norm) * RAD2DEG;
-            longitude = std::atan2(t.v3.y, t.v3.x) * RAD2DEG;
-            v = 0.5 - latitude/180.0;
-            u = longitude/360.0 + 0.5;
-            vertices[count_triangles +  6] = u;
-            vertices[count_triangles +  7] = v;
-
-            count_triangles = count_triangles + 8;
-        }
-        
-        // load data into buffer
-        int N = part.triangles.size();
-        float STRIDE_VBO = 3 * (3 + 3 + 2) * sizeof(float);
-        glBindBuffer(GL_ARRAY_BUFFER, foo.VBO[count]);
-        glBufferData(GL_ARRAY_BUFFER, STRIDE_VBO*N, vertices, GL_STATIC_DRAW);
-
-        // specify format [position, normals, uv]
-        float STRIDE_VAO = (3 + 3 + 2) * sizeof(float);
-        glBindVertexArray(foo.VAO[count]);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, STRIDE_VAO, (void*)0);                     // position
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, STRIDE_VAO, (void*)(3 * sizeof(float)));   // normals
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, STRIDE_VAO, (void*)(6 * sizeof(float)));   // uv
-        glEnableVertexAttribArray(2);
-                
-        count++;
-        
-        if( count == N_parts )
-            break;
-    }
+    AssetLoader loader(*this);
+    loader.AddTexturedSphere(root_dir, fn_csv, fn_textureDiffuse, fn_textureSpecular, scale);
+    return loader.Load(0)[0];
+}
 
-    return foo;    
+CAD GL::LoadProceduralSphere(
+        int level,
+        float radius,
+        const std::string& fn_textureDiffuse, 
+        const std::string& fn_textureSpecular,
+        float scale)
+{
+    // same vertex layout as LoadTexturedSphere, generated instead of parsed
+    AssetLoader loader(*this);
+    loader.AddProceduralSphere(level, radius, fn_textureDiffuse, fn_textureSpecular, scale);
+    return loader.Load(0)[0];
 }
 
 void GL::setTriadState(bool triadOn)
@@ -521,8 +979,8 @@ void GL::setTriadState(bool triadOn)
 void GL::DeleteCAD(CAD& cad){
 
     if (cad.initialized == true){
-        delete cad.VAO;
-        delete cad.VBO;
+        cad.mesh.Delete();
+        cad.lod.Delete();
         cad.initialized = false;
     }
 }
@@ -542,54 +1000,187 @@ glm::vec3 GL::VBS2GL(Vector& r_vbs){
     return r_gl;
 }
 
-void GL::VertexShader(CAD& cad, float d_near_gl, float d_far_gl){
+// sub-frustum of one tile: the image plane at the near distance spans the sensor
+// (Nu*dx by Nv*dy at focal length fx, fy), the tile selects its part of it
+static glm::mat4 TilePerspective(const Camera& camera, const Tile& tile, float d_near_gl, float d_far_gl){
 
     // saturate at 10 [cm]
     if (d_near_gl < 0.1)
         d_near_gl = 0.1;
 
-    glm::mat4 projection = glm::perspective(glm::radians(m_camera.FOV_vertical_deg), (float)m_camera.Nu / (float)m_camera.Nv, d_near_gl, d_far_gl);
-    glm::mat4 view = m_camera.GetViewMatrix();
-    glm::mat4 model;
-    cad.shader.setMat4("projection", projection);
-    cad.shader.setMat4("view", view);
-    cad.shader.setMat4("model", model);
+    float halfWidth = d_near_gl * camera.Nu * camera.dx / camera.fx / 2;
+    float halfHeight = d_near_gl * camera.Nv * camera.dy / camera.fy / 2;
+    float left = -halfWidth + 2*halfWidth * tile.x / camera.Nu;
+    float right = -halfWidth + 2*halfWidth * (tile.x + tile.width) / camera.Nu;
+    float bottom = -halfHeight + 2*halfHeight * tile.y / camera.Nv;
+    float top = -halfHeight + 2*halfHeight * (tile.y + tile.height) / camera.Nv;
+    return glm::frustum(left, right, bottom, top, d_near_gl, d_far_gl);
+}
+
+// the whole frame is the tile covering the sensor, so tiled and untiled frames share one camera model
+static glm::mat4 Perspective(const Camera& camera, float d_near_gl, float d_far_gl){
+    Tile frame = {0, 0, camera.Nu, camera.Nv};
+    return TilePerspective(camera, frame, d_near_gl, d_far_gl);
+}
+
+glm::mat4 GL::Projection(float d_near_gl, float d_far_gl){
+    if (m_tileOn)
+        return TilePerspective(m_camera, m_tile, d_near_gl, d_far_gl);
+    return Perspective(m_camera, d_near_gl, d_far_gl);
+}
+
+void GL::VertexShader(CAD& cad, float d_near_gl, float d_far_gl){
+
+    // the model matrix is set by DrawCAD, the view matrix comes with the frame block if declared
+    ProgramUniforms& uniforms = m_renderState.Uniforms(cad.shader.ID);
+    glm::mat4 projection = Projection(d_near_gl, d_far_gl);
+    uniforms.SetMat4("projection", &projection[0][0]);
+    if (uniforms.m_frameBlock == GL_INVALID_INDEX){
+        glm::mat4 view = m_camera.GetViewMatrix();
+        uniforms.SetMat4("view", &view[0][0]);
+    }
+}
+
+static void SetLight(float light[4][4], const glm::vec3& r_Go2Lo_gl){
+    const float rgb[3] = {0.05f, 0.4f, 0.5f};    // ambient, diffuse, specular
+    for (int c = 0; c < 3; c++)
+        light[0][c] = r_Go2Lo_gl[c];
+    light[0][3] = 0.0f;
+    for (int k = 0; k < 3; k++){
+        light[1 + k][0] = light[1 + k][1] = light[1 + k][2] = rgb[k];
+        light[1 + k][3] = 0.0f;
+    }
 }
 
 void GL::FragmentShader(CAD& cad){
     // be sure to activate shader when setting uniforms/drawing objects
-    cad.shader.use();        
-    cad.shader.setVec3("r_Go2Vo_gl", m_camera.Position);
-    cad.shader.setFloat("material.shininess", 32.0f);
-    cad.shader.setInt("material.diffuse", 0);
-    cad.shader.setInt("material.specular", 1);
+    // (cached: program binds and unchanged uniform values are skipped)
+    m_renderState.UseProgram(cad.shader.ID);
+    ProgramUniforms& uniforms = m_renderState.Uniforms(cad.shader.ID);
+    uniforms.SetFloat("material.shininess", 32.0f);
+    uniforms.SetInt("material.diffuse", 0);
+    uniforms.SetInt("material.specular", 1);
+
+    bool sunOn = m_sun.initialized && m_sun.on;
+    bool moonOn = m_moon.initialized && m_moon.on;
+    bool lampOn = m_lamp.initialized && m_lamp.on;
+
+    // camera and lights shared by every shader: one uniform block, uploaded when it changes
+    if (uniforms.m_frameBlock != GL_INVALID_INDEX){
+        FrameBlock frame;
+        std::memset(&frame, 0, sizeof(frame));
+        glm::mat4 view = m_camera.GetViewMatrix();
+        std::memcpy(frame.view, &view[0][0], sizeof(frame.view));
+        for (int c = 0; c < 3; c++)
+            frame.r_Go2Vo_gl[c] = m_camera.Position[c];
+        if (sunOn)
+            SetLight(frame.sun, VBS2GL(m_sun.r_vbs));
+        if (moonOn)
+            SetLight(frame.moon, VBS2GL(m_moon.r_vbs));
+        if (lampOn)
+            SetLight(frame.sun, VBS2GL(m_lamp.r_vbs));
+        m_renderState.UpdateFrameBlock(frame);
+        return;
+    }
+
+    uniforms.SetVec3("r_Go2Vo_gl", m_camera.Position.x, m_camera.Position.y, m_camera.Position.z);
 
     // directional light (Sun)
-    if (m_sun.initialized && m_sun.on ){
+    if (sunOn){
         glm::vec3 r_Vo2So_gl = VBS2GL(m_sun.r_vbs);
-        cad.shader.setVec3("sun.r_Go2Lo_gl", r_Vo2So_gl);
-        cad.shader.setVec3("sun.ambient", 0.05f, 0.05f, 0.05f);
-        cad.shader.setVec3("sun.diffuse", 0.4f, 0.4f, 0.4f);
-        cad.shader.setVec3("sun.specular", 0.5f, 0.5f, 0.5f);
+        uniforms.SetVec3("sun.r_Go2Lo_gl", r_Vo2So_gl.x, r_Vo2So_gl.y, r_Vo2So_gl.z);
+        uniforms.SetVec3("sun.ambient", 0.05f, 0.05f, 0.05f);
+        uniforms.SetVec3("sun.diffuse", 0.4f, 0.4f, 0.4f);
+        uniforms.SetVec3("sun.specular", 0.5f, 0.5f, 0.5f);
     }
 
     // directional light (Moon)
-    if (m_moon.initialized && m_moon.on ){
+    if (moonOn){
         glm::vec3 r_Vo2Mo_gl = VBS2GL(m_moon.r_vbs);
-        cad.shader.setVec3("moon.r_Go2Lo_gl", r_Vo2Mo_gl);
-        cad.shader.setVec3("moon.ambient", 0.05f, 0.05f, 0.05f);
-        cad.shader.setVec3("moon.diffuse", 0.4f, 0.4f, 0.4f);
-        cad.shader.setVec3("moon.specular", 0.5f, 0.5f, 0.5f);
+        uniforms.SetVec3("moon.r_Go2Lo_gl", r_Vo2Mo_gl.x, r_Vo2Mo_gl.y, r_Vo2Mo_gl.z);
+        uniforms.SetVec3("moon.ambient", 0.05f, 0.05f, 0.05f);
+        uniforms.SetVec3("moon.diffuse", 0.4f, 0.4f, 0.4f);
+        uniforms.SetVec3("moon.specular", 0.5f, 0.5f, 0.5f);
     }
 
     // directional light (Lamp)
-    if (m_lamp.initialized && m_lamp.on ){
+    if (lampOn){
         glm::vec3 r_Vo2Lo_gl = VBS2GL(m_lamp.r_vbs);
-        cad.shader.setVec3("sun.r_Go2Lo_gl", r_Vo2Lo_gl);
-        cad.shader.setVec3("sun.ambient", 0.05f, 0.05f, 0.05f);
-        cad.shader.setVec3("sun.diffuse", 0.4f, 0.4f, 0.4f);
-        cad.shader.setVec3("sun.specular", 0.5f, 0.5f, 0.5f);
+        uniforms.SetVec3("sun.r_Go2Lo_gl", r_Vo2Lo_gl.x, r_Vo2Lo_gl.y, r_Vo2Lo_gl.z);
+        uniforms.SetVec3("sun.ambient", 0.05f, 0.05f, 0.05f);
+        uniforms.SetVec3("sun.diffuse", 0.4f, 0.4f, 0.4f);
+        uniforms.SetVec3("sun.specular", 0.5f, 0.5f, 0.5f);
+    }
+}
+
+void GL::SetShadowSize(int size){
+    // 0 turns sun shadows off; maps are reallocated on their next use
+    m_shadowSize = std::max(0, size);
+}
+
+void GL::DeleteShadowMaps(){
+    for (auto& entry : m_shadowMaps)
+        entry.second.Delete();
+    m_shadowMaps.clear();
+}
+
+void GL::SunShadow(CAD& cad, const glm::mat4& model){
+
+    // the lamp takes the sun's slot in the shaders
+    bool sunOn = m_sun.initialized && m_sun.on && !(m_lamp.initialized && m_lamp.on);
+
+    // shaders opt in by declaring the shadow uniforms (see ShadowMap); one that does not is drawn
+    // unshadowed, said once per program so a scene without shadows does not go unnoticed
+    ProgramUniforms& uniforms = m_renderState.Uniforms(cad.shader.ID);
+    if (!uniforms.Has("sunShadowMatrix")){
+        if (sunOn && m_shadowSize > 0 && m_unshadowedShaders.insert(cad.shader.ID).second)
+            std::cout << "Sun shadows: shader " << cad.shader.ID << " does not declare sunShadowMatrix, "
+                      << "drawn unshadowed" << std::endl;
+        return;
+    }
+    ShadowMap* shadow = NULL;
+    if (sunOn && m_shadowSize > 0){
+        shadow = &m_shadowMaps[&cad];
+        if (shadow->m_size != m_shadowSize && !shadow->Create(m_shadowSize)){
+            std::cout << "Sun shadows disabled" << std::endl;
+            m_shadowSize = 0;
+            shadow = NULL;
+        }
     }
+
+    if (shadow != NULL){
+        // sun direction in the model frame (the scale is uniform): the map is reused for as long as
+        // the body keeps its attitude relative to the sun, wherever the camera goes
+        glm::vec3 sun_model = glm::normalize(glm::transpose(glm::mat3(model)) * glm::normalize(VBS2GL(m_sun.r_vbs)));
+        double sun[3] = {sun_model.x, sun_model.y, sun_model.z};
+        if (!shadow->Current(cad.mesh, sun)){
+            ProfileScope profile(m_profiler, Profiler::STAGE_SHADOW, true);
+            shadow->Render(cad.mesh, sun);
+            m_renderState.Invalidate();
+        }
+    }
+
+    m_renderState.UseProgram(cad.shader.ID);
+    uniforms.SetInt("sunShadowOn", shadow != NULL ? 1 : 0);
+    if (shadow == NULL)
+        return;
+    m_shadowedDraws++;
+    glm::mat4 modelToMap;
+    std::memcpy(&modelToMap[0][0], shadow->m_matrix, sizeof(shadow->m_matrix));
+    glm::mat4 worldToMap = modelToMap * glm::inverse(model);
+    uniforms.SetMat4("sunShadowMatrix", &worldToMap[0][0]);
+    uniforms.SetInt("sunShadow", ShadowMap::UNIT);
+    m_renderState.BindTexture2D(GL_TEXTURE0 + ShadowMap::UNIT, shadow->m_depth);
+}
+
+glm::mat4 GL::ModelMatrix(CAD& cad){
+    Vector anglevec = Quaternion2AngleVec(cad.q_vbs2body);
+    float angle_deg = anglevec(0) * RAD2DEG;
+    glm::mat4 model;
+    model = glm::translate(model, VBS2GL(cad.r_vbs));
+    if( angle_deg != 0)
+        model = glm::rotate(model, glm::radians(angle_deg), glm::vec3(anglevec(1), anglevec(2), anglevec(3)));
+    return glm::scale(model, glm::vec3(cad.scale));
 }
 
 void GL::DrawCAD(CAD& cad){
@@ -597,76 +1188,204 @@ void GL::DrawCAD(CAD& cad){
     if(cad.initialized == false || cad.on == false)
         return;
 
-    FragmentShader(cad);    
     float d_near_vbs = Norm(cad.r_vbs) - alphaNearFarPlane*cad.scale;
     float d_far_vbs = d_near_vbs + 2*alphaNearFarPlane*cad.scale;
+
+    // the model matrix is shared by every part of the assembly
+    glm::mat4 model = ModelMatrix(cad);
+    glm::vec3 r_gl = VBS2GL(cad.r_vbs);
+
+    // software renderer: the whole assembly, triangles outside the frame are rejected while binning
+    if (m_software){
+        if (cad.soft){
+            glm::mat4 projection = Projection(d_near_vbs, d_far_vbs);
+            m_soft.Draw(*cad.soft, &model[0][0], &projection[0][0]);
+        }
+        return;
+    }
+
+    // cull parts outside the frustum, pick the coarsest level still below m_lodPixelError
+    glm::mat4 clip = Projection(d_near_vbs, d_far_vbs) * m_camera.GetViewMatrix() * model;
+    float range = glm::length(r_gl - m_camera.Position) / cad.scale;
+    float focalPixels = m_camera.fy / m_camera.dy;
+    Mesh* mesh = cad.lod.Select(cad.mesh, &clip[0][0], focalPixels, range, m_lodPixelError);
+    if (mesh == NULL)
+        return;
+
+    SunShadow(cad, model);
+    FragmentShader(cad);    
     VertexShader(cad, d_near_vbs, d_far_vbs);
     
-    // bind diffuse map
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, cad.texture.diffuse);
+    // bind diffuse and specular maps (skipped when already bound)
+    m_renderState.BindTexture2D(GL_TEXTURE0, cad.texture.diffuse);
+    m_renderState.BindTexture2D(GL_TEXTURE1, cad.texture.specular);
 
-    // bind specular map
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, cad.texture.specular);
+    m_renderState.Uniforms(cad.shader.ID).SetMat4("model", &model[0][0]);
 
-    // render containers
-    int count = 0;
-    for(auto part : cad.assembly.parts){
-        
-        glBindVertexArray(cad.VAO[count]);
-        
-        // calculate the model matrix for each object and pass it to shader before drawing
-        Vector anglevec = Quaternion2AngleVec(cad.q_vbs2body);
-        float angle_deg = anglevec(0) * RAD2DEG;
-        glm::vec3 r_gl = VBS2GL(cad.r_vbs);
-        glm::mat4 model;
-        model = glm::translate(model, r_gl);
-        if( angle_deg != 0)
-            model = glm::rotate(model, glm::radians(angle_deg), glm::vec3(anglevec(1), anglevec(2), anglevec(3)));
-        model = glm::scale(model, glm::vec3(cad.scale));
-        cad.shader.setMat4("model", model);
-
-        //glDrawArrays(GL_TRIANGLES, 0, 36);
-        glDrawArrays(GL_TRIANGLES, 0, 3*part.triangles.size());
-        
-        count++;
+    // render all visible parts in one call
+    mesh->DrawParts(cad.lod.m_visible);
+}
+
+void GL::DrawLabels(CAD& cad, int firstId){
+
+    if(m_labelsOn == false || m_tileOn || cad.initialized == false || cad.on == false)
+        return;
+
+    // same matrices and level of detail as DrawCAD, so the labels cover the shaded pixels
+    float d_near_vbs = Norm(cad.r_vbs) - alphaNearFarPlane*cad.scale;
+    float d_far_vbs = d_near_vbs + 2*alphaNearFarPlane*cad.scale;
+    glm::mat4 model = ModelMatrix(cad);
+    glm::mat4 view = m_camera.GetViewMatrix();
+    glm::mat4 projection = Projection(d_near_vbs, d_far_vbs);
+    glm::mat4 clip = projection * view * model;
+    float range = glm::length(VBS2GL(cad.r_vbs) - m_camera.Position) / cad.scale;
+    float focalPixels = m_camera.fy / m_camera.dy;
+    Mesh* mesh = cad.lod.Select(cad.mesh, &clip[0][0], focalPixels, range, m_lodPixelError);
+    if (mesh == NULL)
+        return;
+
+    m_labels.Draw(*mesh, cad.lod.m_visible, &model[0][0], &view[0][0], &projection[0][0], firstId);
+
+    // the label pass binds its own program
+    m_renderState.Invalidate();
+}
+
+void GL::ModelToCamera(CAD& cad, const float* p, int N, double* x, double* y, double* z){
+
+    // model frame -> GL camera frame -> camera frame (x right, y down, z along the boresight)
+    glm::mat4 modelView = m_camera.GetViewMatrix() * ModelMatrix(cad);
+    for (int i = 0; i < N; i++){
+        glm::vec4 q = modelView * glm::vec4(p[3*i], p[3*i + 1], p[3*i + 2], 1.0f);
+        x[i] = q.x;
+        y[i] = -q.y;
+        z[i] = -q.z;
     }
 }
 
 void GL::DrawRGBStar(Vector& n_vbs, Vector& rgb){
     // also draw the lamp object(s)
     //glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)screen_width_pix / (float)screen_height_pix, 0.1f, 100.0f);;
-    glm::mat4 projection = glm::perspective(glm::radians(m_camera.FOV_vertical_deg), (float)m_camera.Nu / (float)m_camera.Nv, 0.1f, 100.0f);
+    glm::mat4 projection = Projection(0.1f, 100.0f);
     glm::mat4 view = m_camera.GetViewMatrix();
-    m_star.shader.use();
-    m_star.shader.setMat4("projection", projection);
-    m_star.shader.setMat4("view", view);
 
     float d = 50.0;
-    int count = 0;
-    for(auto part : m_star.assembly.parts){
-        glBindVertexArray(m_star.VAO[count]);
 
-        // coordinate transformation
-        glm::vec3 r_gl = VBS2GL(d*n_vbs);
+    // coordinate transformation
+    glm::vec3 r_gl = VBS2GL(d*n_vbs);
 
-        glm::mat4 model;
-        model = glm::translate(model, r_gl);
-        model = glm::scale(model, glm::vec3(m_star.scale)); 
-        m_star.shader.setMat4("model", model);
+    glm::mat4 model;
+    model = glm::translate(model, r_gl);
+    model = glm::scale(model, glm::vec3(m_star.scale)); 
 
-        // radiometric mapping
-        glm::vec3 rgb(rgb(0), rgb(1), rgb(2));
-        m_star.shader.setVec3("RGB", rgb);
-        
-        //glDrawArrays(GL_TRIANGLES, 0, 36);
-        glDrawArrays(GL_TRIANGLES, 0, 3*part.triangles.size());
+    if (m_software){
+        if (m_star.soft){
+            float color[3] = {(float) rgb(0), (float) rgb(1), (float) rgb(2)};
+            m_soft.Draw(*m_star.soft, &model[0][0], &projection[0][0], color);
+        }
+        return;
+    }
+
+    m_renderState.UseProgram(m_star.shader.ID);
+    ProgramUniforms& uniforms = m_renderState.Uniforms(m_star.shader.ID);
+    uniforms.SetMat4("projection", &projection[0][0]);
+    uniforms.SetMat4("view", &view[0][0]);
+    uniforms.SetMat4("model", &model[0][0]);
+
+    // radiometric mapping
+    uniforms.SetVec3("RGB", rgb(0), rgb(1), rgb(2));
+    
+    m_star.mesh.Draw();
+}
+
+void GL::DrawStars(const Matrix& n_vbs, const Matrix& rgb){
+
+    int N = n_vbs.nRows();
+    if (m_star.initialized == false || N == 0)
+        return;
 
-        count++;
+    // software renderer: one flat-colored star mesh per star
+    if (m_software){
+        Vector n(3), c(3);
+        for (int i=0; i<N; i++){
+            for (int j=0; j<3; j++){
+                n(j) = n_vbs(i,j);
+                c(j) = rgb(i,j);
+            }
+            DrawRGBStar(n, c);
+        }
+        return;
+    }
+
+    // wrap the star mesh with an instanced VAO on first use, again whenever its buffers change
+    if (!m_starField.Current(m_star.mesh.m_VBO, m_star.mesh.m_EBO, m_star.mesh.m_stride, m_star.mesh.ElementCount())){
+        if (!m_starField.Create(m_star.mesh.m_VBO, m_star.mesh.m_EBO, m_star.mesh.m_stride, m_star.mesh.ElementCount()))
+            return;
+    }
+
+    // one instance per star: direction in GL frame and rgb
+    m_starDirections.resize(3*N);
+    m_starRGB.resize(3*N);
+    for (int i=0; i<N; i++){
+        m_starDirections[3*i + 0] =  n_vbs(i,0);
+        m_starDirections[3*i + 1] = -n_vbs(i,1);
+        m_starDirections[3*i + 2] = -n_vbs(i,2);
+        m_starRGB[3*i + 0] = rgb(i,0);
+        m_starRGB[3*i + 1] = rgb(i,1);
+        m_starRGB[3*i + 2] = rgb(i,2);
     }
+    m_starField.Upload(m_starDirections.data(), m_starRGB.data(), N);
+
+    // same placement as DrawRGBStar: stars at 50 [m], matrices computed once per field
+    glm::mat4 projection = Projection(0.1f, 100.0f);
+    glm::mat4 view = m_camera.GetViewMatrix();
+    float d = 50.0;
+    m_starField.Draw(&projection[0][0], &view[0][0], d, m_star.scale);
+
+    // the star field binds its own program
+    m_renderState.Invalidate();
 }
 
+void GL::SetStarPSF(const StarPhotometry& photometry, float sigma){
+    m_starLUT.Build(photometry);
+    m_starSigma = sigma;
+    m_starSplat.SetLUT(m_starLUT);
+}
+
+float GL::StarSignal(double mag) const{
+    return m_starLUT.Signal((float) mag);
+}
+
+void GL::SplatStars(const float* stars, int N){
+
+    if (N == 0)
+        return;
+
+    glm::mat4 projection = Projection(0.1f, 100.0f);
+
+    // software renderer: the magnitudes go through the table on the CPU
+    if (m_software){
+        m_starSignal.assign(stars, stars + 4*N);
+        for (int i=0; i<N; i++)
+            m_starSignal[4*i + 3] = m_starLUT.Signal(stars[4*i + 3]);
+        m_soft.Splat(m_starSignal.data(), N, &projection[0][0], m_starSigma);
+        return;
+    }
+
+    if (m_starSplat.m_initialized == false){
+        if (!m_starSplat.Create())
+            return;
+        m_starSplat.SetLUT(m_starLUT);
+    }
+    m_starSplat.Upload(stars, N);
+
+    glm::mat4 view = m_camera.GetViewMatrix();
+    int width = m_tileOn ? m_tile.width : m_camera.Nu;
+    int height = m_tileOn ? m_tile.height : m_camera.Nv;
+    m_starSplat.Draw(&projection[0][0], &view[0][0], width, height, m_starSigma);
+
+    // the splat pass binds its own program
+    m_renderState.Invalidate();
+}
 
 void GL::RenderDots(const Matrix& n_vbs, const Matrix& rgb){
 
@@ -676,12 +1395,10 @@ void GL::RenderDots(const Matrix& n_vbs, const Matrix& rgb){
     ClearScreen();
 
     // render stars    
-    for(int i=0; i<n_vbs.nRows(); i++){
-        DrawRGBStar(n_vbs.Row(i), rgb.Row(i));
-    }
+    DrawStars(n_vbs, rgb);
         
     // swap buffers
-    glfwSwapBuffers(m_window);
+    SwapBuffers();
     
 }
 
@@ -826,6 +1543,9 @@ void GL::AnalyzeShader(Vector& r_Vo2Co_vbs, Vector& q_vbs2body, Vector& r_Vo2So_
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
 void GL::ProcessInput(){
 
+    if (m_headless)
+        return;
+
     // per-frame time logic
     float currentFrame = glfwGetTime();
     deltaTime = currentFrame - lastFrame;
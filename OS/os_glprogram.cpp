@@ -0,0 +1,63 @@
+// OS_GLPROGRAM.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: compiles the small built-in GLSL programs used by the
+//              rendering passes that do not load shaders from disk
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_glprogram.hpp"
+
+#include <iostream>
+
+static GLuint CompileStage(GLenum stage, const char* source, const char* name){
+
+    GLuint shader = glCreateShader(stage);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success){
+        char infoLog[1024];
+        glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+        std::cout << "Shader compilation error (" << name << ", "
+                  << (stage == GL_VERTEX_SHADER ? "vertex" : "fragment") << "):\n" << infoLog << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint CompileProgram(const char* vertexSource, const char* fragmentSource, const char* name){
+
+    GLuint vs = CompileStage(GL_VERTEX_SHADER, vertexSource, name);
+    GLuint fs = CompileStage(GL_FRAGMENT_SHADER, fragmentSource, name);
+    if (vs == 0 || fs == 0){
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success){
+        char infoLog[1024];
+        glGetProgramInfoLog(program, 1024, NULL, infoLog);
+        std::cout << "Program linking error (" << name << "):\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
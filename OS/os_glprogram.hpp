@@ -0,0 +1,21 @@
+// OS_GLPROGRAM.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: compiles the small built-in GLSL programs used by the
+//              rendering passes that do not load shaders from disk
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_GLPROGRAM_HPP
+#define OS_GLPROGRAM_HPP
+
+#include "include/glad/glad.h"
+
+// link a vertex + fragment program from source, returns 0 on failure (log printed with 'name')
+GLuint CompileProgram(const char* vertexSource, const char* fragmentSource, const char* name);
+
+#endif
@@ -0,0 +1,176 @@
+// OS_HEADLESS.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: windowless OpenGL context for offscreen rendering
+//              Linux: EGL surfaceless context (works on Mesa llvmpipe)
+//              other: hidden GLFW window
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "include/glad/glad.h"
+#include "os_headless.hpp"
+
+#include <iostream>
+
+#if defined(__linux__)
+    #include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext() :
+    m_initialized(false)
+{
+#if defined(__linux__)
+    m_display = EGL_NO_DISPLAY;
+    m_context = EGL_NO_CONTEXT;
+#else
+    m_window = NULL;
+#endif
+}
+
+#if defined(__linux__)
+
+bool HeadlessContext::Create(int major, int minor){
+
+    // prefer Mesa's surfaceless platform (no X server / GBM device required)
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLint eglMajor, eglMinor;
+    if (getPlatformDisplay != NULL)
+        m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+
+    // the extension can be exported by a driver that cannot bring the platform up: use the default display
+    if (m_display != EGL_NO_DISPLAY && !eglInitialize(m_display, &eglMajor, &eglMinor)){
+        eglTerminate(m_display);
+        m_display = EGL_NO_DISPLAY;
+    }
+    if (m_display == EGL_NO_DISPLAY){
+        m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, &eglMajor, &eglMinor)){
+            std::cout << "Failed to initialize EGL display" << std::endl;
+            m_display = EGL_NO_DISPLAY;
+            return false;
+        }
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)){
+        std::cout << "EGL does not support desktop OpenGL" << std::endl;
+        eglTerminate(m_display);
+        return false;
+    }
+
+    // no surface is ever created, all rendering goes into framebuffer objects
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_DEPTH_SIZE,      24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(m_display, configAttribs, &config, 1, &numConfigs) || numConfigs == 0){
+        std::cout << "Failed to choose an EGL config" << std::endl;
+        eglTerminate(m_display);
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR,       major,
+        EGL_CONTEXT_MINOR_VERSION_KHR,       minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (m_context == EGL_NO_CONTEXT){
+        std::cout << "Failed to create EGL context" << std::endl;
+        eglTerminate(m_display);
+        return false;
+    }
+
+    m_initialized = true;
+    MakeCurrent();
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)){
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    return true;
+}
+
+void HeadlessContext::Destroy(){
+
+    if (m_initialized == false)
+        return;
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+    m_display = EGL_NO_DISPLAY;
+    m_context = EGL_NO_CONTEXT;
+    m_initialized = false;
+}
+
+void HeadlessContext::MakeCurrent(){
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context);
+}
+
+#else
+
+bool HeadlessContext::Create(int major, int minor){
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    #ifdef __APPLE__
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // OS X only
+    #endif
+
+    // the window is never shown; its default framebuffer is unused
+    m_window = glfwCreateWindow(1, 1, "OpticalStimulator (headless)", NULL, NULL);
+    if (m_window == NULL){
+        std::cout << "Failed to create hidden GLFW window" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+
+    m_initialized = true;
+    MakeCurrent();
+    glfwSwapInterval(0);
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)){
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    return true;
+}
+
+void HeadlessContext::Destroy(){
+
+    if (m_initialized == false)
+        return;
+
+    glfwDestroyWindow(m_window);
+    glfwTerminate();
+    m_window = NULL;
+    m_initialized = false;
+}
+
+void HeadlessContext::MakeCurrent(){
+    glfwMakeContextCurrent(m_window);
+}
+
+#endif
@@ -0,0 +1,44 @@
+// OS_HEADLESS.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: windowless OpenGL context for offscreen rendering
+//              Linux: EGL surfaceless context (works on Mesa llvmpipe)
+//              other: hidden GLFW window
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_HEADLESS_HPP
+#define OS_HEADLESS_HPP
+
+#if defined(__linux__)
+    #include <EGL/egl.h>
+#else
+    #include <GLFW/glfw3.h>
+#endif
+
+class HeadlessContext
+{
+public:
+    HeadlessContext();
+
+    // create a core-profile context, make it current and load the GL function pointers
+    bool Create(int major, int minor);
+    void Destroy();
+    void MakeCurrent();
+
+    bool m_initialized;
+
+private:
+#if defined(__linux__)
+    EGLDisplay m_display;
+    EGLContext m_context;
+#else
+    GLFWwindow* m_window;
+#endif
+};
+
+#endif
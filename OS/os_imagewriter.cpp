@@ -0,0 +1,120 @@
+// OS_IMAGEWRITER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: pool of encoder threads fed by a bounded queue so image
+//              compression and file I/O overlap with rendering
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_imagewriter.hpp"
+
+#include <exception>
+#include <iostream>
+
+ImageWriter::ImageWriter() :
+    m_running(false),
+    m_capacity(0),
+    m_busy(0),
+    m_failures(0),
+    m_stop(false)
+{
+}
+
+ImageWriter::~ImageWriter()
+{
+    Join();
+}
+
+void ImageWriter::Start(int nThreads, int queueCapacity, EncodeFunction encode){
+
+    Join();
+
+    m_encode = encode;
+    m_capacity = queueCapacity < 1 ? 1 : queueCapacity;
+    m_busy = 0;
+    m_failures = 0;
+    m_stop = false;
+
+    for (int i = 0; i < nThreads; i++)
+        m_threads.push_back(std::thread(&ImageWriter::Worker, this));
+    m_running = true;
+}
+
+void ImageWriter::Submit(ReadbackFrame&& frame){
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvSpace.wait(lock, [this]{ return m_queue.size() < m_capacity; });
+    m_queue.push_back(std::move(frame));
+    lock.unlock();
+    m_cvWork.notify_one();
+}
+
+int ImageWriter::Flush(){
+
+    if (m_running == false)
+        return 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvIdle.wait(lock, [this]{ return m_queue.empty() && m_busy == 0; });
+    int failures = m_failures;
+    m_failures = 0;
+    return failures;
+}
+
+void ImageWriter::Join(){
+
+    if (m_running == false)
+        return;
+
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cvWork.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+    m_threads.clear();
+    m_running = false;
+}
+
+void ImageWriter::Worker(){
+
+    while (true){
+        ReadbackFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvWork.wait(lock, [this]{ return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+                return;
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy++;
+        }
+        m_cvSpace.notify_one();
+
+        // an exception escaping a worker would terminate the process: report it, drop the frame
+        bool written = false;
+        try {
+            written = m_encode(frame);
+            if (!written)
+                std::cout << "ImageWriter: failed to write " << frame.filename << std::endl;
+        }catch (const std::exception& e){
+            std::cout << "ImageWriter: failed to write " << frame.filename << ": " << e.what() << std::endl;
+        }catch (...){
+            std::cout << "ImageWriter: failed to write " << frame.filename << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+            if (!written)
+                m_failures++;
+        }
+        m_cvIdle.notify_all();
+    }
+}
@@ -0,0 +1,66 @@
+// OS_IMAGEWRITER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: pool of encoder threads fed by a bounded queue so image
+//              compression and file I/O overlap with rendering
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_IMAGEWRITER_HPP
+#define OS_IMAGEWRITER_HPP
+
+#include "os_readback.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ImageWriter
+{
+public:
+    // called on a worker thread; takes ownership of the frame's pixels,
+    // returns false when the frame could not be encoded or written
+    typedef std::function<bool(ReadbackFrame&)> EncodeFunction;
+
+    ImageWriter();
+    ~ImageWriter();
+
+    void Start(int nThreads, int queueCapacity, EncodeFunction encode);
+
+    // enqueue a frame, blocks while the queue is full (backpressure on the render loop)
+    void Submit(ReadbackFrame&& frame);
+
+    // wait until every submitted frame has been written, returns the number
+    // of frames that failed since the previous Flush
+    int Flush();
+
+    // flush and stop the worker threads
+    void Join();
+
+    bool m_running;
+
+private:
+    void Worker();
+
+    EncodeFunction m_encode;
+    std::vector<std::thread> m_threads;
+    std::deque<ReadbackFrame> m_queue;
+    size_t m_capacity;
+    int m_busy;
+    int m_failures;
+    bool m_stop;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;       // queue not empty (or stopping)
+    std::condition_variable m_cvSpace;      // queue not full
+    std::condition_variable m_cvIdle;       // queue empty and no frame in progress
+};
+
+#endif
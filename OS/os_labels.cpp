@@ -0,0 +1,222 @@
+// OS_LABELS.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: ground-truth label targets rendered next to the colour
+//              image: per-part instance mask and linear depth, one
+//              texture-array layer per frame like the batch target
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_labels.hpp"
+#include "os_framebuffer.hpp"
+#include "os_glprogram.hpp"
+
+#include <iostream>
+
+// position only (location 0 of every CAD vertex format)
+static const char* LABEL_VS = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+out float depth;
+void main()
+{
+    vec4 p = view * model * vec4(aPos, 1.0);
+    depth = -p.z;
+    gl_Position = projection * p;
+}
+)";
+
+static const char* LABEL_FS = R"(
+#version 330 core
+uniform uint id;
+in float depth;
+layout (location = 0) out uint mask;
+layout (location = 1) out float linearDepth;
+void main()
+{
+    mask = id;
+    linearDepth = depth;
+}
+)";
+
+LabelTarget::LabelTarget() :
+    m_width(0),
+    m_height(0),
+    m_layers(0),
+    m_layer(0),
+    m_initialized(false),
+    m_fbo(0),
+    m_mask(0),
+    m_depthLinear(0),
+    m_depth(0),
+    m_pboMask(0),
+    m_pboDepth(0),
+    m_pboMaskBytes(0),
+    m_pboDepthBytes(0),
+    m_program(0)
+{
+}
+
+static GLuint LabelArray(GLint internalFormat, GLenum format, GLenum type, int width, int height, int layers){
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return texture;
+}
+
+bool LabelTarget::Create(int width, int height, int layers){
+
+    // release any previous allocation
+    Delete();
+
+    if (m_program == 0){
+        m_program = CompileProgram(LABEL_VS, LABEL_FS, "labels");
+        if (m_program == 0)
+            return false;
+        m_locModel = glGetUniformLocation(m_program, "model");
+        m_locView = glGetUniformLocation(m_program, "view");
+        m_locProjection = glGetUniformLocation(m_program, "projection");
+        m_locId = glGetUniformLocation(m_program, "id");
+    }
+
+    GLint drawFbo;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+
+    m_width = width;
+    m_height = height;
+    m_layers = layers;
+    m_layer = 0;
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    m_mask = LabelArray(GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT, width, height, layers);
+    m_depthLinear = LabelArray(GL_R32F, GL_RED, GL_FLOAT, width, height, layers);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_mask, 0, 0);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_depthLinear, 0, 0);
+    const GLenum DRAW_BUFFERS[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, DRAW_BUFFERS);
+
+    // depth attachment, cleared between frames so a single plane is enough
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    m_initialized = true;
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, drawFbo);
+    if (!complete){
+        std::cout << "Label framebuffer is incomplete (" << width << "x" << height << "x" << layers << ")" << std::endl;
+        Delete();
+        return false;
+    }
+    return true;
+}
+
+void LabelTarget::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteTextures(1, &m_mask);
+    glDeleteTextures(1, &m_depthLinear);
+    glDeleteRenderbuffers(1, &m_depth);
+    glDeleteFramebuffers(1, &m_fbo);
+    if (m_pboMask != 0)
+        glDeleteBuffers(1, &m_pboMask);
+    if (m_pboDepth != 0)
+        glDeleteBuffers(1, &m_pboDepth);
+    m_pboMask = m_pboDepth = 0;
+    m_pboMaskBytes = m_pboDepthBytes = 0;
+    glDeleteProgram(m_program);
+    m_program = 0;
+    m_layers = 0;
+    m_fbo = 0;
+    m_mask = 0;
+    m_depthLinear = 0;
+    m_depth = 0;
+    m_initialized = false;
+}
+
+void LabelTarget::BindLayer(int layer){
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_fbo);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_mask, 0, layer);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, m_depthLinear, 0, layer);
+}
+
+void LabelTarget::ClearLayer(int layer){
+
+    GLint drawFbo;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+
+    m_layer = layer;
+    BindLayer(layer);
+    const GLuint BACKGROUND_ID[4] = {0, 0, 0, 0};
+    const GLfloat BACKGROUND_DEPTH[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const GLfloat FAR_PLANE = 1.0f;
+    glClearBufferuiv(GL_COLOR, 0, BACKGROUND_ID);
+    glClearBufferfv(GL_COLOR, 1, BACKGROUND_DEPTH);
+    glClearBufferfv(GL_DEPTH, 0, &FAR_PLANE);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+}
+
+void LabelTarget::Draw(Mesh& mesh, const std::vector<unsigned char>& visible, const float model[16], const float view[16],
+                       const float projection[16], int firstId){
+
+    if (m_initialized == false || mesh.m_initialized == false)
+        return;
+
+    GLint drawFbo;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+
+    // same viewport as the colour target (both camera sized)
+    BindLayer(m_layer);
+    glUseProgram(m_program);
+    glUniformMatrix4fv(m_locModel, 1, GL_FALSE, model);
+    glUniformMatrix4fv(m_locView, 1, GL_FALSE, view);
+    glUniformMatrix4fv(m_locProjection, 1, GL_FALSE, projection);
+
+    // the id changes per part: one draw per visible part (assemblies have a handful)
+    for (size_t k = 0; k < mesh.m_count.size() && k < visible.size(); k++){
+        if (visible[k] == 0 || mesh.m_count[k] == 0)
+            continue;
+        glUniform1ui(m_locId, (GLuint) (firstId + k));
+        mesh.DrawPart((int) k);
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+}
+
+void LabelTarget::ReadLayers(int N, uint16_t* mask, float* depth){
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if (N == m_layers){
+        // whole arrays in a single transfer each
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_mask);
+        glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, mask);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthLinear);
+        glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RED, GL_FLOAT, depth);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+    else{
+        // partially filled batch: one transfer per array through a pack buffer, only the rendered layers copied
+        size_t framePixels = (size_t) m_width * m_height;
+        ReadTextureLayers(m_mask, GL_RED_INTEGER, GL_UNSIGNED_SHORT, sizeof(uint16_t)*framePixels, N, m_layers,
+                          m_pboMask, m_pboMaskBytes, mask);
+        ReadTextureLayers(m_depthLinear, GL_RED, GL_FLOAT, sizeof(float)*framePixels, N, m_layers,
+                          m_pboDepth, m_pboDepthBytes, depth);
+    }
+}
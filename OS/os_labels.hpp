@@ -0,0 +1,70 @@
+// OS_LABELS.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: ground-truth label targets rendered next to the colour
+//              image: per-part instance mask and linear depth, one
+//              texture-array layer per frame like the batch target
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_LABELS_HPP
+#define OS_LABELS_HPP
+
+#include "include/glad/glad.h"
+#include "os_mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// attachment 0: GL_R16UI instance id (0 = background, firstId + k for part k)
+// attachment 1: GL_R32F linear depth along the boresight [m] (0 = background)
+// own depth buffer, so only the labelled bodies occlude each other
+class LabelTarget
+{
+public:
+    LabelTarget();
+
+    bool Create(int width, int height, int layers);
+    void Delete();
+
+    // draw target for one frame: binds the layer and clears it (restores the previous draw framebuffer)
+    void ClearLayer(int layer);
+
+    // visible parts of mesh into the current layer, matrices column-major as uploaded to the CAD shaders;
+    // leaves its program and vertex array bound (RenderState must be invalidated)
+    void Draw(Mesh& mesh, const std::vector<unsigned char>& visible, const float model[16], const float view[16],
+              const float projection[16], int firstId);
+
+    // first N layers, N * width * height values each, bottom-up rows like the colour readback
+    void ReadLayers(int N, uint16_t* mask, float* depth);
+
+    int m_width;
+    int m_height;
+    int m_layers;
+    int m_layer;                    // layer the next Draw goes to
+    bool m_initialized;
+
+private:
+    void BindLayer(int layer);
+
+    GLuint m_fbo;
+    GLuint m_mask;
+    GLuint m_depthLinear;
+    GLuint m_depth;
+    GLuint m_pboMask;               // partial batch readback (see ReadTextureLayers)
+    GLuint m_pboDepth;
+    size_t m_pboMaskBytes;
+    size_t m_pboDepthBytes;
+    GLuint m_program;
+    GLint m_locModel;
+    GLint m_locView;
+    GLint m_locProjection;
+    GLint m_locId;
+};
+
+#endif
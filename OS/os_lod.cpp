@@ -0,0 +1,219 @@
+// OS_LOD.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: level of detail and visibility for CAD meshes: chains of
+//              vertex-clustered (decimated) copies selected by projected
+//              error, and per-part frustum culling with bounding spheres
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_lod.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------
+// Frustum
+// ------------------------------------------------------------------------
+void Frustum::Extract(const float m[16]){
+
+    // Gribb & Hartmann: rows of m combined, row i = (m[i], m[4+i], m[8+i], m[12+i])
+    for (int k = 0; k < 6; k++){
+        int axis = k / 2;
+        float sign = (k % 2 == 0) ? 1.0f : -1.0f;
+        float length = 0.0f;
+        for (int c = 0; c < 4; c++){
+            m_planes[k][c] = m[4*c + 3] + sign * m[4*c + axis];
+            if (c < 3)
+                length += m_planes[k][c] * m_planes[k][c];
+        }
+        length = std::sqrt(length);
+        if (length > 0.0f)
+            for (int c = 0; c < 4; c++)
+                m_planes[k][c] /= length;
+    }
+}
+
+bool Frustum::SphereVisible(const float center[3], float radius) const{
+    for (int k = 0; k < 6; k++){
+        const float* p = m_planes[k];
+        if (p[0]*center[0] + p[1]*center[1] + p[2]*center[2] + p[3] < -radius)
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// MeshLOD
+// ------------------------------------------------------------------------
+MeshLOD::MeshLOD() :
+    m_stride(0),
+    m_radius(0.0f)
+{
+    m_center[0] = m_center[1] = m_center[2] = 0.0f;
+}
+
+void MeshLOD::Build(const void* vertices, size_t vertexBytes, GLsizei stride,
+                    const std::vector<VertexAttribute>& attributes, const GLuint* indices, size_t nIndices,
+                    const std::vector<GLint>& first, const std::vector<GLsizei>& count, int nLevels){
+
+    m_pending.clear();
+    m_error.clear();
+    m_attributes = attributes;
+    m_stride = stride;
+
+    const unsigned char* base = (const unsigned char*) vertices;
+    size_t nVertices = vertexBytes / stride;
+    if (nVertices == 0 || nLevels <= 0)
+        return;
+
+    auto Position = [&](size_t v, float p[3]){ std::memcpy(p, base + v*stride, 3*sizeof(float)); };
+    auto Index = [&](size_t e){ return (nIndices > 0) ? indices[e] : (GLuint) e; };
+
+    // grid origin and extent of the whole assembly
+    float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t v = 0; v < nVertices; v++){
+        float p[3];
+        Position(v, p);
+        for (int c = 0; c < 3; c++){
+            lo[c] = std::min(lo[c], p[c]);
+            hi[c] = std::max(hi[c], p[c]);
+        }
+    }
+    float diagonal = std::sqrt((hi[0]-lo[0])*(hi[0]-lo[0]) + (hi[1]-lo[1])*(hi[1]-lo[1]) + (hi[2]-lo[2])*(hi[2]-lo[2]));
+    if (diagonal <= 0.0f)
+        return;
+
+    size_t nTriangles = (nIndices > 0 ? nIndices : nVertices) / 3;
+    std::unordered_map<uint64_t, GLuint> cells;
+    for (int level = 1; level <= nLevels; level++){
+
+        // vertex clustering: one representative vertex (the first seen) per grid cell and part;
+        // triangles collapsing to an edge or a point are dropped
+        float cell = diagonal * (float) (1 << level) / 1024.0f;
+        LevelData data;
+        for (size_t k = 0; k < first.size(); k++){
+            cells.clear();
+            data.first.push_back((GLint) data.indices.size());
+            for (GLsizei e = 0; e + 2 < count[k]; e += 3){
+                GLuint tri[3];
+                for (int j = 0; j < 3; j++){
+                    GLuint v = Index(first[k] + e + j);
+                    float p[3];
+                    Position(v, p);
+                    uint64_t key = 0;
+                    for (int c = 0; c < 3; c++)
+                        key = (key << 21) | ((uint64_t) ((p[c] - lo[c]) / cell) & 0x1FFFFF);
+                    auto it = cells.find(key);
+                    if (it == cells.end()){
+                        GLuint index = (GLuint) (data.vertices.size() / stride);
+                        data.vertices.insert(data.vertices.end(), base + v*stride, base + (v + 1)*stride);
+                        it = cells.emplace(key, index).first;
+                    }
+                    tri[j] = it->second;
+                }
+                if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2])
+                    data.indices.insert(data.indices.end(), tri, tri + 3);
+            }
+            data.count.push_back((GLsizei) (data.indices.size() - data.first.back()));
+        }
+
+        // a level that barely reduces the triangle count is not worth a draw-time choice
+        size_t levelTriangles = data.indices.size() / 3;
+        if (levelTriangles == 0)
+            break;
+        if (levelTriangles > nTriangles * 3 / 4)
+            continue;
+        nTriangles = levelTriangles;
+        m_error.push_back(cell * std::sqrt(3.0f));
+        m_pending.push_back(std::move(data));
+    }
+}
+
+void MeshLOD::Upload(){
+
+    for (auto& mesh : m_levels)
+        mesh.Delete();
+    m_levels.resize(m_pending.size());
+    for (size_t i = 0; i < m_pending.size(); i++){
+        const LevelData& data = m_pending[i];
+        m_levels[i].UploadRaw(data.vertices.data(), data.vertices.size(), m_stride, m_attributes,
+                              data.indices.data(), data.indices.size(), data.first, data.count, NULL);
+    }
+    m_pending.clear();
+}
+
+void MeshLOD::Delete(){
+    for (auto& mesh : m_levels)
+        mesh.Delete();
+    m_levels.clear();
+    m_error.clear();
+    m_pending.clear();
+    m_spheres.clear();
+}
+
+Mesh* MeshLOD::Select(Mesh& full, const float clip[16], float focalPixels, float range, float maxPixelError){
+
+    size_t nParts = full.m_first.size();
+
+    // bounding spheres from the per-part boxes of the full mesh (shared by every level)
+    if (m_spheres.size() != 4*nParts){
+        m_spheres.resize(4*nParts);
+        float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (size_t k = 0; k < nParts; k++){
+            const float* b = &full.m_bounds[6*k];
+            float r2 = 0.0f;
+            if (full.m_count[k] == 0){
+                m_spheres[4*k + 0] = m_spheres[4*k + 1] = m_spheres[4*k + 2] = m_spheres[4*k + 3] = 0.0f;
+                continue;
+            }
+            for (int c = 0; c < 3; c++){
+                m_spheres[4*k + c] = 0.5f*(b[c] + b[3 + c]);
+                r2 += 0.25f*(b[3 + c] - b[c])*(b[3 + c] - b[c]);
+                lo[c] = std::min(lo[c], b[c]);
+                hi[c] = std::max(hi[c], b[3 + c]);
+            }
+            m_spheres[4*k + 3] = std::sqrt(r2);
+        }
+        float r2 = 0.0f;
+        for (int c = 0; c < 3; c++){
+            m_center[c] = 0.5f*(lo[c] + hi[c]);
+            r2 += 0.25f*(hi[c] - lo[c])*(hi[c] - lo[c]);
+        }
+        m_radius = nParts > 0 ? std::sqrt(r2) : 0.0f;
+    }
+
+    Frustum frustum;
+    frustum.Extract(clip);
+    m_visible.assign(nParts, 0);
+    if (nParts == 0 || !frustum.SphereVisible(m_center, m_radius))
+        return NULL;
+
+    bool any = false;
+    for (size_t k = 0; k < nParts; k++){
+        m_visible[k] = frustum.SphereVisible(&m_spheres[4*k], m_spheres[4*k + 3]) ? 1 : 0;
+        any = any || m_visible[k];
+    }
+    if (!any)
+        return NULL;
+
+    // error projected at the nearest point of the bounding sphere
+    float reach = std::sqrt(m_center[0]*m_center[0] + m_center[1]*m_center[1] + m_center[2]*m_center[2]) + m_radius;
+    float distance = std::max(range - reach, 1e-3f * std::max(m_radius, 1e-3f));
+    float pixelsPerUnit = focalPixels / distance;
+    Mesh* mesh = &full;
+    for (size_t i = 0; i < m_levels.size(); i++){
+        if (m_error[i] * pixelsPerUnit > maxPixelError)
+            break;
+        mesh = &m_levels[i];
+    }
+    return mesh;
+}
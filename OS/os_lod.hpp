@@ -0,0 +1,79 @@
+// OS_LOD.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: level of detail and visibility for CAD meshes: chains of
+//              vertex-clustered (decimated) copies selected by projected
+//              error, and per-part frustum culling with bounding spheres
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_LOD_HPP
+#define OS_LOD_HPP
+
+#include "os_mesh.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// clip-space planes, p is visible when dot(plane, [p 1]) >= 0 for all six
+class Frustum
+{
+public:
+    // m: column-major 4x4 mapping to clip space, e.g. projection*view*model;
+    // planes come out in the input space of m (model space for the example)
+    void Extract(const float m[16]);
+
+    // exact for similarity transforms (rotation, uniform scale, translation)
+    bool SphereVisible(const float center[3], float radius) const;
+
+    float m_planes[6][4];
+};
+
+class MeshLOD
+{
+public:
+    MeshLOD();
+
+    // CPU only (worker thread): up to nLevels coarser copies of the full mesh, position is
+    // the first 3 floats of a vertex; non-indexed input when nIndices = 0
+    void Build(const void* vertices, size_t vertexBytes, GLsizei stride,
+               const std::vector<VertexAttribute>& attributes, const GLuint* indices, size_t nIndices,
+               const std::vector<GLint>& first, const std::vector<GLsizei>& count, int nLevels);
+
+    // GL thread: uploads the levels from Build and frees their CPU copies
+    void Upload();
+    void Delete();
+
+    // per frame: culls the parts of 'full' against clip (projection*view*model) into m_visible and
+    // returns the coarsest mesh whose error stays under maxPixelError, NULL if nothing is visible
+    //   focalPixels:  focal length [pix]
+    //   range:        camera to model origin, in model units (range / scale)
+    Mesh* Select(Mesh& full, const float clip[16], float focalPixels, float range, float maxPixelError);
+
+    std::vector<Mesh> m_levels;             // coarser copies, same part table as the full mesh
+    std::vector<float> m_error;             // max vertex displacement per level [model units]
+    std::vector<unsigned char> m_visible;   // per part, from the last Select
+
+private:
+    struct LevelData
+    {
+        std::vector<unsigned char> vertices;
+        std::vector<GLuint> indices;
+        std::vector<GLint> first;
+        std::vector<GLsizei> count;
+    };
+
+    std::vector<LevelData> m_pending;
+    std::vector<VertexAttribute> m_attributes;
+    GLsizei m_stride;
+
+    std::vector<float> m_spheres;           // per part: center xyz, radius
+    float m_center[3];                      // whole assembly
+    float m_radius;
+};
+
+#endif
@@ -0,0 +1,337 @@
+// OS_MESH.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GPU mesh of a whole CAD assembly: one interleaved vertex
+//              buffer, one VAO and a part table drawn with a single
+//              glMultiDrawArrays / glMultiDrawElements call
+//              MeshBuilder welds shared STL vertices into an indexed,
+//              compact vertex format
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_mesh.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+Mesh::Mesh() :
+    m_VAO(0),
+    m_VBO(0),
+    m_EBO(0),
+    m_stride(0),
+    m_initialized(false)
+{
+}
+
+bool Mesh::Upload(const std::vector<float>& vertices, const std::vector<int>& components,
+                  const std::vector<GLint>& first, const std::vector<GLsizei>& count){
+
+    std::vector<VertexAttribute> attributes = FloatAttributes(components);
+    GLsizei stride = 0;
+    for (int c : components)
+        stride += c * sizeof(float);
+
+    return UploadRaw(vertices.data(), sizeof(float)*vertices.size(), stride, attributes,
+                     NULL, 0, first, count, NULL);
+}
+
+std::vector<VertexAttribute> Mesh::FloatAttributes(const std::vector<int>& components){
+
+    std::vector<VertexAttribute> attributes;
+    GLsizei offset = 0;
+    for (int c : components){
+        attributes.push_back({c, GL_FLOAT, GL_FALSE, offset});
+        offset += c * sizeof(float);
+    }
+    return attributes;
+}
+
+bool Mesh::UploadIndexed(const std::vector<unsigned char>& vertices, GLsizei stride,
+                         const std::vector<VertexAttribute>& attributes, const std::vector<GLuint>& indices,
+                         const std::vector<GLint>& first, const std::vector<GLsizei>& count){
+    return UploadRaw(vertices.data(), vertices.size(), stride, attributes,
+                     indices.data(), indices.size(), first, count, NULL);
+}
+
+void Mesh::SetParts(const void* vertices, GLsizei stride, const GLuint* indices, size_t nIndices,
+                    const std::vector<GLint>& first, const std::vector<GLsizei>& count, const float* bounds){
+
+    m_first = first;
+    m_count = count;
+    m_stride = stride;
+
+    // part bounding boxes (position is always the first 3 floats of a vertex)
+    size_t nParts = first.size();
+    if (bounds != NULL)
+        m_bounds.assign(bounds, bounds + 6*nParts);
+    else{
+        m_bounds.assign(6*nParts, 0.0f);
+        const unsigned char* base = (const unsigned char*) vertices;
+        for (size_t k = 0; k < nParts; k++){
+            float* b = &m_bounds[6*k];
+            for (int c = 0; c < 3; c++){
+                b[c] = FLT_MAX;
+                b[3 + c] = -FLT_MAX;
+            }
+            for (GLsizei e = 0; e < count[k]; e++){
+                size_t v = (nIndices > 0) ? indices[first[k] + e] : (size_t) (first[k] + e);
+                float p[3];
+                std::memcpy(p, base + v*stride, sizeof(p));
+                for (int c = 0; c < 3; c++){
+                    b[c] = std::min(b[c], p[c]);
+                    b[3 + c] = std::max(b[3 + c], p[c]);
+                }
+            }
+        }
+    }
+}
+
+bool Mesh::UploadRaw(const void* vertices, size_t vertexBytes, GLsizei stride,
+                     const std::vector<VertexAttribute>& attributes, const GLuint* indices, size_t nIndices,
+                     const std::vector<GLint>& first, const std::vector<GLsizei>& count, const float* bounds){
+
+    Delete();
+    SetParts(vertices, stride, indices, nIndices, first, count, bounds);
+
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+
+    // load data into buffer
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertices, GL_STATIC_DRAW);
+    if (nIndices > 0){
+        // byte offsets of every part inside the index buffer
+        for (GLint f : m_first)
+            m_indexOffsets.push_back((const void*) (f * sizeof(GLuint)));
+
+        glGenBuffers(1, &m_EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*nIndices, indices, GL_STATIC_DRAW);
+    }
+    SetupAttributes(attributes);
+
+    // the element buffer binding is VAO state, unbind the VAO first
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_initialized = true;
+    return true;
+}
+
+void Mesh::SetupAttributes(const std::vector<VertexAttribute>& attributes){
+    for (size_t i = 0; i < attributes.size(); i++){
+        const VertexAttribute& a = attributes[i];
+        glVertexAttribPointer(i, a.size, a.type, a.normalized, m_stride, (void*)(size_t) a.offset);
+        glEnableVertexAttribArray(i);
+    }
+}
+
+void Mesh::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_VBO);
+    if (m_EBO != 0)
+        glDeleteBuffers(1, &m_EBO);
+    m_VAO = 0;
+    m_VBO = 0;
+    m_EBO = 0;
+    m_first.clear();
+    m_count.clear();
+    m_bounds.clear();
+    m_indexOffsets.clear();
+    m_initialized = false;
+}
+
+void Mesh::Draw(){
+
+    if (m_initialized == false || m_first.empty())
+        return;
+
+    glBindVertexArray(m_VAO);
+    if (m_EBO != 0)
+        glMultiDrawElements(GL_TRIANGLES, m_count.data(), GL_UNSIGNED_INT, m_indexOffsets.data(), (GLsizei) m_count.size());
+    else
+        glMultiDrawArrays(GL_TRIANGLES, m_first.data(), m_count.data(), (GLsizei) m_first.size());
+}
+
+void Mesh::DrawParts(const std::vector<unsigned char>& visible){
+
+    if (m_initialized == false || m_first.empty())
+        return;
+
+    m_drawFirst.clear();
+    m_drawCount.clear();
+    m_drawOffsets.clear();
+    for (size_t k = 0; k < m_first.size() && k < visible.size(); k++){
+        if (visible[k] == 0 || m_count[k] == 0)
+            continue;
+        m_drawFirst.push_back(m_first[k]);
+        m_drawCount.push_back(m_count[k]);
+        if (m_EBO != 0)
+            m_drawOffsets.push_back(m_indexOffsets[k]);
+    }
+    if (m_drawCount.empty())
+        return;
+
+    glBindVertexArray(m_VAO);
+    if (m_EBO != 0)
+        glMultiDrawElements(GL_TRIANGLES, m_drawCount.data(), GL_UNSIGNED_INT, m_drawOffsets.data(), (GLsizei) m_drawCount.size());
+    else
+        glMultiDrawArrays(GL_TRIANGLES, m_drawFirst.data(), m_drawCount.data(), (GLsizei) m_drawCount.size());
+}
+
+void Mesh::DrawPart(int k){
+
+    if (m_initialized == false || k < 0 || k >= (int) m_count.size() || m_count[k] == 0)
+        return;
+
+    glBindVertexArray(m_VAO);
+    if (m_EBO != 0)
+        glDrawElements(GL_TRIANGLES, m_count[k], GL_UNSIGNED_INT, m_indexOffsets[k]);
+    else
+        glDrawArrays(GL_TRIANGLES, m_first[k], m_count[k]);
+}
+
+int Mesh::ElementCount() const{
+    if (m_first.empty())
+        return 0;
+    return m_first.back() + m_count.back();
+}
+
+// ------------------------------------------------------------------------
+// MeshBuilder
+// ------------------------------------------------------------------------
+
+// signed normalized 10-10-10-2 (GL_INT_2_10_10_10_REV), w = 0
+static uint32_t PackNormal(const float n[3]){
+    uint32_t packed = 0;
+    for (int k = 0; k < 3; k++){
+        float c = n[k] < -1.0f ? -1.0f : (n[k] > 1.0f ? 1.0f : n[k]);
+        int32_t q = (int32_t) std::lround(c * 511.0f);
+        packed |= ((uint32_t) q & 0x3FFu) << (10*k);
+    }
+    return packed;
+}
+
+bool MeshBuilder::Key::operator==(const Key& o) const{
+    return std::memcmp(this, &o, sizeof(Key)) == 0;
+}
+
+size_t MeshBuilder::KeyHash::operator()(const Key& k) const{
+    // FNV-1a over the raw float bits
+    const unsigned char* b = (const unsigned char*) &k;
+    size_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < sizeof(Key); i++){
+        h ^= b[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+MeshBuilder::MeshBuilder(bool quantizeNormals) :
+    m_quantizeNormals(quantizeNormals)
+{
+    // position (12) + normal (4 packed or 12) + color (4)
+    m_stride = 12 + (quantizeNormals ? 4 : 12) + 4;
+    m_color[0] = m_color[1] = m_color[2] = m_color[3] = 255;
+}
+
+void MeshBuilder::Reserve(size_t nVertices){
+    m_vertices.reserve(nVertices * m_stride);
+    m_indices.reserve(nVertices);
+}
+
+void MeshBuilder::BeginPart(float r, float g, float b){
+    const float rgb[3] = {r, g, b};
+    for (int k = 0; k < 3; k++){
+        float c = rgb[k] < 0.0f ? 0.0f : (rgb[k] > 1.0f ? 1.0f : rgb[k]);
+        m_color[k] = (unsigned char) std::lround(c * 255.0f);
+    }
+    m_first.push_back((GLint) m_indices.size());
+    m_weld.clear();
+}
+
+void MeshBuilder::AddVertex(const float p[3], const float n[3]){
+
+    Key key;
+    std::memcpy(key.p, p, sizeof(key.p));
+    std::memcpy(key.n, n, sizeof(key.n));
+
+    // reuse an identical vertex of the same part
+    auto it = m_weld.find(key);
+    if (it != m_weld.end()){
+        m_indices.push_back(it->second);
+        return;
+    }
+
+    GLuint index = (GLuint) (m_vertices.size() / m_stride);
+    size_t offset = m_vertices.size();
+    m_vertices.resize(offset + m_stride);
+    unsigned char* dst = &m_vertices[offset];
+    std::memcpy(dst, p, 12);
+    if (m_quantizeNormals){
+        uint32_t packed = PackNormal(n);
+        std::memcpy(dst + 12, &packed, 4);
+        std::memcpy(dst + 16, m_color, 4);
+    }
+    else{
+        std::memcpy(dst + 12, n, 12);
+        std::memcpy(dst + 24, m_color, 4);
+    }
+
+    m_weld.emplace(key, index);
+    m_indices.push_back(index);
+}
+
+void MeshBuilder::EndPart(){
+    m_count.push_back((GLsizei) (m_indices.size() - m_first.back()));
+    m_weld.clear();
+}
+
+void MeshBuilder::Append(const MeshBuilder& other){
+
+    GLuint base = (GLuint) (m_vertices.size() / m_stride);
+    GLint indexBase = (GLint) m_indices.size();
+
+    m_vertices.insert(m_vertices.end(), other.m_vertices.begin(), other.m_vertices.end());
+    m_indices.reserve(m_indices.size() + other.m_indices.size());
+    for (GLuint index : other.m_indices)
+        m_indices.push_back(base + index);
+    for (size_t k = 0; k < other.m_first.size(); k++){
+        m_first.push_back(indexBase + other.m_first[k]);
+        m_count.push_back(other.m_count[k]);
+    }
+}
+
+std::vector<VertexAttribute> MeshBuilder::Attributes() const{
+
+    // locations match the shaders: 0 position, 1 normal, 2 rgb
+    std::vector<VertexAttribute> attributes;
+    attributes.push_back({3, GL_FLOAT, GL_FALSE, 0});
+    if (m_quantizeNormals){
+        attributes.push_back({4, GL_INT_2_10_10_10_REV, GL_TRUE, 12});
+        attributes.push_back({3, GL_UNSIGNED_BYTE, GL_TRUE, 16});
+    }
+    else{
+        attributes.push_back({3, GL_FLOAT, GL_FALSE, 12});
+        attributes.push_back({3, GL_UNSIGNED_BYTE, GL_TRUE, 24});
+    }
+    return attributes;
+}
+
+bool MeshBuilder::Upload(Mesh& mesh) const{
+    return mesh.UploadIndexed(m_vertices, m_stride, Attributes(), m_indices, m_first, m_count);
+}
@@ -0,0 +1,138 @@
+// OS_MESH.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GPU mesh of a whole CAD assembly: one interleaved vertex
+//              buffer, one VAO and a part table drawn with a single
+//              glMultiDrawArrays / glMultiDrawElements call
+//              MeshBuilder welds shared STL vertices into an indexed,
+//              compact vertex format
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_MESH_HPP
+#define OS_MESH_HPP
+
+#include "include/glad/glad.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+struct VertexAttribute
+{
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei offset;             // [bytes] from the start of the vertex
+};
+
+class Mesh
+{
+public:
+    Mesh();
+
+    // non-indexed: interleaved floats, attribute i has 'components[i]' floats (location i)
+    // first/count: vertex range of every part inside the buffer
+    bool Upload(const std::vector<float>& vertices, const std::vector<int>& components,
+                const std::vector<GLint>& first, const std::vector<GLsizei>& count);
+
+    // indexed: raw vertex bytes described by 'attributes' (location i), 32-bit indices;
+    // first/count: index range of every part inside the index buffer
+    bool UploadIndexed(const std::vector<unsigned char>& vertices, GLsizei stride,
+                       const std::vector<VertexAttribute>& attributes, const std::vector<GLuint>& indices,
+                       const std::vector<GLint>& first, const std::vector<GLsizei>& count);
+
+    // common path (nIndices = 0 for non-indexed); bounds: 6 floats per part (min xyz, max xyz),
+    // computed from the vertices when NULL
+    bool UploadRaw(const void* vertices, size_t vertexBytes, GLsizei stride,
+                   const std::vector<VertexAttribute>& attributes, const GLuint* indices, size_t nIndices,
+                   const std::vector<GLint>& first, const std::vector<GLsizei>& count, const float* bounds);
+    void Delete();
+
+    // CPU side of UploadRaw only: parts and their bounds, no GL objects (software renderer)
+    void SetParts(const void* vertices, GLsizei stride, const GLuint* indices, size_t nIndices,
+                  const std::vector<GLint>& first, const std::vector<GLsizei>& count, const float* bounds);
+
+    // tightly packed float attributes, e.g. {3, 3, 2}
+    static std::vector<VertexAttribute> FloatAttributes(const std::vector<int>& components);
+
+    // all parts in one call
+    void Draw();
+
+    // only the parts with visible[k] != 0, still one call
+    void DrawParts(const std::vector<unsigned char>& visible);
+
+    // part k alone (callers that change uniforms between parts)
+    void DrawPart(int k);
+
+    // vertices (non-indexed) or indices (indexed) covered by all parts
+    int ElementCount() const;
+
+    GLuint m_VAO;
+    GLuint m_VBO;
+    GLuint m_EBO;               // 0 for non-indexed meshes
+    GLsizei m_stride;           // [bytes]
+    std::vector<GLint> m_first;
+    std::vector<GLsizei> m_count;
+    std::vector<float> m_bounds;            // per part: min xyz, max xyz (model frame)
+    bool m_initialized;
+
+private:
+    void SetupAttributes(const std::vector<VertexAttribute>& attributes);
+
+    std::vector<const void*> m_indexOffsets;
+
+    // DrawParts scratch, reused between frames
+    std::vector<GLint> m_drawFirst;
+    std::vector<GLsizei> m_drawCount;
+    std::vector<const void*> m_drawOffsets;
+};
+
+// builds the indexed CAD vertex format: position (3 x float), normal, color (RGBA8)
+// normal is 3 x float, or packed 10-10-10-2 when quantizeNormals is set
+class MeshBuilder
+{
+public:
+    MeshBuilder(bool quantizeNormals);
+
+    void BeginPart(float r, float g, float b);
+    void AddVertex(const float p[3], const float n[3]);     // duplicates within a part are welded
+    void EndPart();
+
+    void Reserve(size_t nVertices);
+    bool Upload(Mesh& mesh) const;
+
+    // concatenate the parts of another builder of the same format (parts built in parallel)
+    void Append(const MeshBuilder& other);
+
+    GLsizei Stride() const  { return m_stride; };
+    std::vector<VertexAttribute> Attributes() const;
+
+    std::vector<unsigned char> m_vertices;
+    std::vector<GLuint> m_indices;
+    std::vector<GLint> m_first;
+    std::vector<GLsizei> m_count;
+
+private:
+    struct Key
+    {
+        float p[3];
+        float n[3];
+        bool operator==(const Key& o) const;
+    };
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const;
+    };
+
+    bool m_quantizeNormals;
+    GLsizei m_stride;
+    unsigned char m_color[4];
+    std::unordered_map<Key, GLuint, KeyHash> m_weld;
+};
+
+#endif
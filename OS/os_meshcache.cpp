@@ -0,0 +1,385 @@
+// OS_MESHCACHE.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: binary cache of preprocessed CAD meshes, memory-mapped and
+//              uploaded directly so startup skips CSV/STL parsing
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_meshcache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = {'O', 'S', 'M', 'C'};
+
+MappedFile::MappedFile() :
+    m_data(NULL),
+    m_size(0)
+#ifdef _WIN32
+    , m_file(INVALID_HANDLE_VALUE),
+    m_mapping(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path){
+
+    Close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0){
+        Close();
+        return false;
+    }
+    m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping == NULL){
+        Close();
+        return false;
+    }
+    m_data = (const unsigned char*) MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (size_t) size.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0){
+        close(fd);
+        return false;
+    }
+    void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                  // the mapping keeps the file referenced
+    if (p == MAP_FAILED)
+        return false;
+    m_data = (const unsigned char*) p;
+    m_size = st.st_size;
+#endif
+
+    if (m_data == NULL){
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close(){
+
+#ifdef _WIN32
+    if (m_data != NULL)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != NULL)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_mapping = NULL;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data != NULL)
+        munmap((void*) m_data, m_size);
+#endif
+    m_data = NULL;
+    m_size = 0;
+}
+
+uint64_t MeshCache::Hash(const unsigned char* data, size_t bytes){
+
+    // FNV-1a, 64 bit
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < bytes; i++){
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static bool HashFile(const std::string& path, uint64_t& size, uint64_t& hash){
+
+    MappedFile file;
+    if (!file.Open(path))
+        return false;
+    size = file.Size();
+    hash = MeshCache::Hash(file.Data(), file.Size());
+    return true;
+}
+
+std::vector<std::string> MeshCache::Sources(const std::string& root_dir, const std::string& fn_csv){
+
+    std::vector<std::string> sources;
+    std::string csv = root_dir + fn_csv;
+    sources.push_back(csv);
+
+    // any field ending in .stl is a part file, relative to root_dir
+    std::ifstream in(csv.c_str());
+    std::string line, field;
+    while (std::getline(in, line)){
+        std::replace(line.begin(), line.end(), ';', ',');
+        std::stringstream ss(line);
+        while (std::getline(ss, field, ',')){
+            field.erase(0, field.find_first_not_of(" \t\r\""));
+            field.erase(field.find_last_not_of(" \t\r\"") + 1);
+            if (field.size() < 4)
+                continue;
+            std::string ext = field.substr(field.size() - 4);
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (ext == ".stl")
+                sources.push_back(root_dir + field);
+        }
+    }
+    return sources;
+}
+
+// ------------------------------------------------------------------------
+// serialization helpers
+// ------------------------------------------------------------------------
+static void Put(std::string& out, const void* p, size_t bytes){
+    out.append((const char*) p, bytes);
+    out.append((4 - bytes % 4) % 4, '\0');
+}
+
+template <typename T> static void Put(std::string& out, T value){
+    Put(out, &value, sizeof(T));
+}
+
+struct Reader
+{
+    const unsigned char* p;
+    const unsigned char* end;
+
+    const unsigned char* Take(size_t bytes){
+        size_t padded = bytes + (4 - bytes % 4) % 4;
+        if (p == NULL || (size_t) (end - p) < padded){
+            p = NULL;
+            return NULL;
+        }
+        const unsigned char* q = p;
+        p += padded;
+        return q;
+    }
+
+    template <typename T> bool Get(T& value){
+        const unsigned char* q = Take(sizeof(T));
+        if (q != NULL)
+            std::memcpy(&value, q, sizeof(T));
+        return q != NULL;
+    }
+};
+
+bool MeshCache::Load(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, Mesh& mesh){
+
+    Mapped mapped;
+    return Open(path, sources, format, mapped) && Upload(mapped, mesh);
+}
+
+bool MeshCache::Open(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, Mapped& mapped){
+
+    MappedFile& file = mapped.file;
+    if (!file.Open(path))
+        return false;
+
+    // trailer: hash of everything before it, catches torn or corrupted files
+    uint64_t checksum = 0;
+    if (file.Size() < 8 + sizeof(MAGIC))
+        return false;
+    size_t body = file.Size() - 8;
+    std::memcpy(&checksum, file.Data() + body, 8);
+    if (Hash(file.Data(), body) != checksum){
+        std::cout << "MeshCache: checksum mismatch in " << path << std::endl;
+        return false;
+    }
+    Reader r = {file.Data(), file.Data() + body};
+
+    // header
+    const unsigned char* magic = r.Take(sizeof(MAGIC));
+    uint32_t version = 0, fileFormat = 0, nSources = 0, nAttributes = 0, nParts = 0;
+    int32_t stride = 0;
+    uint64_t vertexBytes = 0, nIndices = 0;
+    r.Get(version); r.Get(fileFormat); r.Get(nSources); r.Get(nAttributes); r.Get(nParts);
+    r.Get(stride); r.Get(vertexBytes); r.Get(nIndices);
+    if (r.p == NULL || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION)
+        return false;
+    if (fileFormat != format || nSources != sources.size())
+        return false;
+    if (nAttributes > 16 || (uint64_t) 32*nParts > file.Size())
+        return false;
+
+    // invalidate on any change to the inputs
+    for (uint32_t i = 0; i < nSources; i++){
+        uint32_t length = 0;
+        uint64_t size = 0, hash = 0, sizeNow = 0, hashNow = 0;
+        r.Get(length);
+        const unsigned char* name = r.Take(length);
+        r.Get(size); r.Get(hash);
+        if (r.p == NULL || sources[i].compare(0, std::string::npos, (const char*) name, length) != 0)
+            return false;
+        if (!HashFile(sources[i], sizeNow, hashNow) || sizeNow != size || hashNow != hash)
+            return false;
+    }
+
+    std::vector<VertexAttribute>& attributes = mapped.attributes;
+    attributes.resize(nAttributes);
+    for (auto& a : attributes){
+        int32_t size = 0, normalized = 0, offset = 0;
+        uint32_t type = 0;
+        r.Get(size); r.Get(type); r.Get(normalized); r.Get(offset);
+        a = {size, (GLenum) type, (GLboolean) (normalized != 0), offset};
+    }
+
+    std::vector<GLint>& first = mapped.first;
+    std::vector<GLsizei>& count = mapped.count;
+    std::vector<float>& bounds = mapped.bounds;
+    first.resize(nParts);
+    count.resize(nParts);
+    bounds.resize(6*nParts);
+    for (uint32_t k = 0; k < nParts; k++){
+        r.Get(first[k]);
+        r.Get(count[k]);
+        for (int c = 0; c < 6; c++)
+            r.Get(bounds[6*k + c]);
+    }
+
+    const unsigned char* vertices = r.Take(vertexBytes);
+    const unsigned char* indices = r.Take(sizeof(GLuint)*nIndices);
+    if (r.p == NULL){
+        std::cout << "MeshCache: truncated file " << path << std::endl;
+        return false;
+    }
+
+    // parts index the index buffer, or the vertices of a non-indexed mesh
+    if (stride <= 0 || vertexBytes % stride != 0){
+        std::cout << "MeshCache: bad stride in " << path << std::endl;
+        return false;
+    }
+    uint64_t limit = nIndices > 0 ? nIndices : vertexBytes / stride;
+    for (uint32_t k = 0; k < nParts; k++){
+        if (first[k] < 0 || count[k] < 0 || (uint64_t) first[k] + (uint64_t) count[k] > limit){
+            std::cout << "MeshCache: part " << k << " out of range in " << path << std::endl;
+            return false;
+        }
+    }
+
+    // the mapping is 4-byte aligned, indices can be handed to GL as is
+    mapped.stride = stride;
+    mapped.vertices = vertices;
+    mapped.vertexBytes = vertexBytes;
+    mapped.indices = (const GLuint*) indices;
+    mapped.nIndices = nIndices;
+    return true;
+}
+
+bool MeshCache::Upload(const Mapped& mapped, Mesh& mesh){
+    return mesh.UploadRaw(mapped.vertices, mapped.vertexBytes, mapped.stride, mapped.attributes,
+                          mapped.indices, mapped.nIndices, mapped.first, mapped.count,
+                          mapped.bounds.data());
+}
+
+bool MeshCache::Save(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, const Mesh& mesh, const std::vector<VertexAttribute>& attributes,
+                     const void* vertices, size_t vertexBytes, const GLuint* indices, size_t nIndices){
+
+    std::string out;
+    out.reserve(vertexBytes + sizeof(GLuint)*nIndices + 4096);
+
+    Put(out, MAGIC, sizeof(MAGIC));
+    Put(out, (uint32_t) VERSION);
+    Put(out, (uint32_t) format);
+    Put(out, (uint32_t) sources.size());
+    Put(out, (uint32_t) attributes.size());
+    Put(out, (uint32_t) mesh.m_first.size());
+    Put(out, (int32_t) mesh.m_stride);
+    Put(out, (uint64_t) vertexBytes);
+    Put(out, (uint64_t) nIndices);
+
+    for (const auto& source : sources){
+        uint64_t size = 0, hash = 0;
+        if (!HashFile(source, size, hash)){
+            std::cout << "MeshCache: cannot read source " << source << ", not caching" << std::endl;
+            return false;
+        }
+        Put(out, (uint32_t) source.size());
+        Put(out, source.data(), source.size());
+        Put(out, size);
+        Put(out, hash);
+    }
+
+    for (const auto& a : attributes){
+        Put(out, (int32_t) a.size);
+        Put(out, (uint32_t) a.type);
+        Put(out, (int32_t) a.normalized);
+        Put(out, (int32_t) a.offset);
+    }
+
+    for (size_t k = 0; k < mesh.m_first.size(); k++){
+        Put(out, (int32_t) mesh.m_first[k]);
+        Put(out, (int32_t) mesh.m_count[k]);
+        Put(out, &mesh.m_bounds[6*k], 6*sizeof(float));
+    }
+
+    Put(out, vertices, vertexBytes);
+    Put(out, indices, sizeof(GLuint)*nIndices);
+    Put(out, Hash((const unsigned char*) out.data(), out.size()));
+
+    // write beside the target and rename, so concurrent readers never see a partial file;
+    // the temporary name is unique per process and call so concurrent writers never share one
+    static std::atomic<unsigned> serial(0);
+#ifdef _WIN32
+    int pid = _getpid();
+#else
+    int pid = getpid();
+#endif
+    std::stringstream tmpName;
+    tmpName << path << ".tmp." << pid << "." << serial++;
+    std::string tmp = tmpName.str();
+    {
+        std::ofstream file(tmp.c_str(), std::ios::binary | std::ios::trunc);
+        file.write(out.data(), out.size());
+        if (!file){
+            std::cout << "MeshCache: failed to write " << tmp << std::endl;
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // replaces an existing cache in one step, unlike rename
+    if (!MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)){
+#else
+    if (std::rename(tmp.c_str(), path.c_str()) != 0){
+#endif
+        std::cout << "MeshCache: failed to rename " << tmp << std::endl;
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,109 @@
+// OS_MESHCACHE.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: binary cache of preprocessed CAD meshes, memory-mapped and
+//              uploaded directly so startup skips CSV/STL parsing
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_MESHCACHE_HPP
+#define OS_MESHCACHE_HPP
+
+#include "os_mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// read-only view of a whole file (mmap / MapViewOfFile)
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const unsigned char* Data() const   { return m_data; };
+    size_t Size() const                 { return m_size; };
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
+
+// file layout (little endian, every section 4-byte aligned):
+//   header    magic "OSMC", version, format, nSources, nAttributes, nParts, stride,
+//             vertexBytes (64 bit), nIndices (64 bit)
+//   sources   per file: path length, path, size (64 bit), FNV-1a hash (64 bit)
+//   attribs   per attribute: size, type, normalized, offset
+//   parts     per part: first, count, bounding box (min xyz, max xyz)
+//   vertices  interleaved, exactly as uploaded
+//   indices   32 bit (none for non-indexed meshes)
+//   checksum  FNV-1a hash (64 bit) of everything above
+class MeshCache
+{
+public:
+    // bumped whenever the layout above or the vertex formats change
+    static const uint32_t VERSION = 3;
+
+    // vertex format tag, a cache written for one format is never loaded as another
+    enum Format
+    {
+        FORMAT_CAD = 1,             // MeshBuilder, float normals
+        FORMAT_CAD_QUANTIZED = 2,   // MeshBuilder, packed normals
+        FORMAT_TEXTURED = 3         // non-indexed [position, normal, uv]
+    };
+
+    // the CSV and every STL it references; a change to any of them invalidates the cache
+    static std::vector<std::string> Sources(const std::string& root_dir, const std::string& fn_csv);
+
+    // a validated cache file, mapped and ready to upload
+    struct Mapped
+    {
+        MappedFile file;
+        GLsizei stride;
+        std::vector<VertexAttribute> attributes;
+        const void* vertices;
+        size_t vertexBytes;
+        const GLuint* indices;
+        size_t nIndices;
+        std::vector<GLint> first;
+        std::vector<GLsizei> count;
+        std::vector<float> bounds;
+    };
+
+    // maps and validates (hashes every source), no GL calls: safe on a worker thread
+    // false if missing, stale, corrupted or of another format
+    static bool Open(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, Mapped& mapped);
+
+    // GL thread, uploads straight from the mapping
+    static bool Upload(const Mapped& mapped, Mesh& mesh);
+
+    // Open + Upload
+    static bool Load(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, Mesh& mesh);
+
+    // writes the data 'mesh' was uploaded from (part table and bounds are taken from 'mesh')
+    static bool Save(const std::string& path, const std::vector<std::string>& sources,
+                     uint32_t format, const Mesh& mesh, const std::vector<VertexAttribute>& attributes,
+                     const void* vertices, size_t vertexBytes, const GLuint* indices, size_t nIndices);
+
+    static uint64_t Hash(const unsigned char* data, size_t bytes);
+};
+
+#endif
@@ -17,11 +17,19 @@
 #include "mex.h"
 #include "mat.h"
 #include "os_opticalstimulator.hpp"
+#include "os_profiler.hpp"
+#include "os_shardwriter.hpp"
+#include "os_tiling.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
 
 using namespace std;
 
 OpticalStimulator::OpticalStimulator(int Nu, int Nv, double ppx, double ppy, double fx, double fy,
-                                     double magThresh, double halfFOV, Matrix R_vbs2os) : 
+                                     double magThresh, double halfFOV, Matrix R_vbs2os, bool headless,
+                                     bool software) : 
     m_Nu(Nu),
     m_Nv(Nv),
     m_ppx(ppx),
@@ -30,8 +38,23 @@ OpticalStimulator::OpticalStimulator(int Nu, int Nv, double ppx, double ppy, dou
     m_fy(fy),
     m_hsc(magThresh, halfFOV),
     m_R_vbs2os(R_vbs2os),
-    m_gl(Nu, Nv, ppx, ppy, fx, fy)
+    m_gl(Nu, Nv, ppx, ppy, fx, fy, headless, software)
 {
+    // star queries use the caller's half field of view [deg]
+    m_skyHalfFOV = halfFOV * DEG2RAD;
+
+    // sky-partitioned copy of every star above magThresh (an all-sky cone) for the render
+    // queries; m_hsc stays as the public catalog behind getHSC()
+    std::vector<SO> catalog = Hipparcos(magThresh, 180.0).StarsInFOV(Vector(0.0, 0.0, 1.0));
+    int N = catalog.size();
+    std::vector<double> x(N), y(N), z(N), mag(N);
+    for(int i=0; i<N; i++){
+        x[i] = catalog[i].v_eci(0);
+        y[i] = catalog[i].v_eci(1);
+        z[i] = catalog[i].v_eci(2);
+        mag[i] = catalog[i].mag;
+    }
+    m_sky.Build(x.data(), y.data(), z.data(), mag.data(), N, m_skyHalfFOV);
 }
 
 int OpticalStimulator::getNu()                 { return m_Nu;       };
@@ -43,28 +66,49 @@ double OpticalStimulator::getFy()              { return m_fy;       };
 const Hipparcos& OpticalStimulator::getHSC()   { return m_hsc;      };
 const Matrix& OpticalStimulator::getR_vbs2os() { return m_R_vbs2os; };
 
+CameraModel OpticalStimulator::GetCameraModel(){
+
+    CameraModel cam;
+    cam.cx = m_gl.m_camera.Nu / 2.0;
+    cam.cy = m_gl.m_camera.Nv / 2.0;
+    cam.fpx = m_gl.m_camera.fx / m_gl.m_camera.dx;
+    cam.fpy = m_gl.m_camera.fy / m_gl.m_camera.dy;
+
+    //"STAR TRACKER REAL-TIME HARDWARE IN THE LOOP TESTING USING OPTICAL STAR SIMULATOR" (AAS 11-260)
+    bool loaded = m_C.nRows() >= 25 && m_D.nRows() >= 25;
+    for(int k=0;k<25;k++){
+        cam.C[k] = loaded ? m_C(k,0) : 0.0;
+        cam.D[k] = loaded ? m_D(k,0) : 0.0;
+    }
+    return cam;
+}
+
 Matrix OpticalStimulator::Pixel2UnitVector(Matrix& uv, int dist){
     
     int N = uv.nRows();
     Matrix xyz(N,3);
-    double x, y, z, norm;
-    double cx = m_gl.m_camera.Nu / 2.0;
-    double cy = m_gl.m_camera.Nv / 2.0;
-    
+
+    if (dist != 0){
+        printf("Pixel2UnitVector: Error\n");
+        return xyz;
+    }
+
+    // back-projection uses the focal length as stored in the camera (fx, fy)
+    CameraModel cam = GetCameraModel();
+    cam.fpx = m_gl.m_camera.fx;
+    cam.fpy = m_gl.m_camera.fy;
+
+    std::vector<double> soa(5*N);
+    double *u = &soa[0], *v = u + N, *x = v + N, *y = x + N, *z = y + N;
     for(int i=0;i<N;i++){
-        switch(dist){
-            case 0:
-                x = (uv(i,0) - cx) / m_gl.m_camera.fx;
-                y = (uv(i,1) - cy) / m_gl.m_camera.fy;
-                z = 1.0;
-                norm = pow(x*x + y*y + z*z, 0.5);
-                xyz(i,0) = x/norm;
-                xyz(i,1) = y/norm;
-                xyz(i,2) = z/norm;
-                break;
-            default:
-                printf("Pixel2UnitVector: Error\n");
-        }
+        u[i] = uv(i,0);
+        v[i] = uv(i,1);
+    }
+    BackProjectPinhole(cam, u, v, N, x, y, z);
+    for(int i=0;i<N;i++){
+        xyz(i,0) = x[i];
+        xyz(i,1) = y[i];
+        xyz(i,2) = z[i];
     }
     
     return xyz;
@@ -72,54 +116,92 @@ Matrix OpticalStimulator::Pixel2UnitVector(Matrix& uv, int dist){
             
 Matrix OpticalStimulator::UnitVector2Pixel(Matrix& xyz, int dist){
     int N = xyz.nRows();
-    Vector xn_pow(5), yn_pow(5);
-    double xn, yn;
     Matrix uv(N,2);
-    
-    double cx = m_gl.m_camera.Nu / 2.0;
-    double cy = m_gl.m_camera.Nv / 2.0;
-    double fpx = m_gl.m_camera.fx / m_gl.m_camera.dx;
-    double fpy = m_gl.m_camera.fy / m_gl.m_camera.dy;
-    
-    //"STAR TRACKER REAL-TIME HARDWARE IN THE LOOP TESTING USING OPTICAL STAR SIMULATOR" (AAS 11-260)
-    Matrix AB(1,25);
-    int col;
-    
+
+    std::vector<double> soa(5*N);
+    double *x = &soa[0], *y = x + N, *z = y + N, *u = z + N, *v = u + N;
     for(int i=0;i<N;i++){
-        xn = xyz(i,0) / xyz(i,2);                                          // small angle approximation xn = x/z
-        yn = xyz(i,1) / xyz(i,2);                                          // small angle approximation yn = y/z
-        switch(dist){
-            case 0:
-                uv(i,0) = fpx*xn + cx;
-                uv(i,1) = fpy*yn + cy;
-                break;
-            case 2:
-                for(int power=0;power<5;power++){
-                    xn_pow(power) = pow(xn,power);
-                    yn_pow(power) = pow(yn,power);
-                }
-                
-                for(int k=0;k<5;k++){
-                    for(int j=0;j<5;j++){
-                        col = 5*k + j;
-                        //AB(0,col) = pow(xn,k) * pow(yn,j);
-                        AB(0,col) = xn_pow(k) * yn_pow(j);
-                    }
-                }
-                uv(i,0) = (double) ((AB*m_C)(0,0));
-                uv(i,1) = (double) ((AB*m_D)(0,0));
-                break;
-            default:
-                printf("UnitVector2Pixel: Error\n");              
-        }
+        x[i] = xyz(i,0);
+        y[i] = xyz(i,1);
+        z[i] = xyz(i,2);
+    }
+    if (!UnitVector2PixelBulk(x, y, z, N, u, v, dist))
+        return uv;
+    for(int i=0;i<N;i++){
+        uv(i,0) = u[i];
+        uv(i,1) = v[i];
     }
    
     return uv;
 }
 
+bool OpticalStimulator::UnitVector2PixelBulk(const double* x, const double* y, const double* z, int N,
+                                             double* u, double* v, int dist){
+    CameraModel cam = GetCameraModel();
+    switch(dist){
+        case 0:
+            ProjectPinhole(cam, x, y, z, N, u, v);
+            return true;
+        case 2:
+            ProjectDistorted(cam, x, y, z, N, u, v);
+            return true;
+        default:
+            printf("UnitVector2Pixel: Error\n");
+            return false;
+    }
+}
+
+void OpticalStimulator::SetLabels(bool labelsOn){
+    m_gl.SetLabels(labelsOn);
+}
+
+void OpticalStimulator::SetKeypoints(Matrix& xyz_body){
+    int N = xyz_body.nRows();
+    m_keypoints.resize(3*N);
+    for(int i=0;i<N;i++)
+        for(int c=0;c<3;c++)
+            m_keypoints[3*i + c] = (float) xyz_body(i,c);
+}
+
+void OpticalStimulator::ProjectKeypoints(CAD& cad){
+
+    // default keypoints: corners of the assembly bounding box
+    if (m_keypoints.empty() && !cad.mesh.m_bounds.empty()){
+        float lo[3], hi[3];
+        for(int c=0;c<3;c++){
+            lo[c] = cad.mesh.m_bounds[c];
+            hi[c] = cad.mesh.m_bounds[3 + c];
+        }
+        for(size_t k=1; k<cad.mesh.m_bounds.size()/6; k++)
+            for(int c=0;c<3;c++){
+                lo[c] = std::min(lo[c], cad.mesh.m_bounds[6*k + c]);
+                hi[c] = std::max(hi[c], cad.mesh.m_bounds[6*k + 3 + c]);
+            }
+        for(int corner=0; corner<8; corner++){
+            m_keypoints.push_back(corner & 1 ? hi[0] : lo[0]);
+            m_keypoints.push_back(corner & 2 ? hi[1] : lo[1]);
+            m_keypoints.push_back(corner & 4 ? hi[2] : lo[2]);
+        }
+    }
+
+    // u, v [pix] through the same pinhole model as UnitVector2Pixel, z [m] comparable to the depth label
+    int N = m_keypoints.size() / 3;
+    std::vector<double> soa(5*N);
+    double *x = soa.data(), *y = x + N, *z = y + N, *u = z + N, *v = u + N;
+    m_gl.ModelToCamera(cad, m_keypoints.data(), N, x, y, z);
+    UnitVector2PixelBulk(x, y, z, N, u, v, 0);
+    m_keypointsUV.resize(3*N);
+    for(int i=0;i<N;i++){
+        m_keypointsUV[3*i + 0] = (float) u[i];
+        m_keypointsUV[3*i + 1] = (float) v[i];
+        m_keypointsUV[3*i + 2] = (float) z[i];
+    }
+}
+
 Vector OpticalStimulator::Magnitude2RGB(double mag)
 {
     // placeholder - linear approx for digital count (dc)
+    // colour of a single-point star (DrawStars); PSF splats use Magnitude2Signal
     double x1 = 4;                    // visual magnitude (bright)
     double x2 = 9;                    // visual magnitude (dim)
     double y1 = 1;                    // digital count (bright)
@@ -133,21 +215,52 @@ Vector OpticalStimulator::Magnitude2RGB(double mag)
     return rgb;
 }
 
+double OpticalStimulator::Magnitude2Signal(double mag)
+{
+    // total signal of a PSF splat from the photometric lookup table (see GL::SetStarPSF),
+    // spread over the kernel rather than landing in one pixel
+    return m_gl.StarSignal(mag);
+}
+
 void OpticalStimulator::DrawSO(const Vector& q_eci2vbs)
 {
+    ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_DRAW_SO, true);
+
     // render stars
     Matrix R_eci2vbs = Quaternion2Rotation(q_eci2vbs);
     Vector z_eci = R_eci2vbs.Row(2);                  // camera boresight vector expressed in (ECI) frame
-    std::vector<SO> stars = m_hsc.StarsInFOV(z_eci);
-    for(auto so : stars){
-        Vector n_vbs = R_eci2vbs * so.v_eci;          // unit vector to SO expressed in (VBS) frame
+    double boresight[3] = {z_eci(0), z_eci(1), z_eci(2)};
+    {
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_STAR_QUERY);
+        m_sky.Query(boresight, m_skyHalfFOV, m_skyHits);
+    }
+
+    double R[3][3];
+    for(int r=0; r<3; r++)
+        for(int c=0; c<3; c++)
+            R[r][c] = R_eci2vbs(r,c);
+
+    // gather the whole field (GL frame direction, magnitude) and splat its PSFs in one pass
+    int N = m_skyHits.size();
+    m_starPacked.resize(4*N);
+    for(int i=0; i<N; i++){
+        int k = m_skyHits[i];
+        double v_eci[3] = {m_sky.m_x[k], m_sky.m_y[k], m_sky.m_z[k]};
+        double n_vbs[3];
+        for(int r=0; r<3; r++)                        // unit vector to SO expressed in (VBS) frame
+            n_vbs[r] = R[r][0]*v_eci[0] + R[r][1]*v_eci[1] + R[r][2]*v_eci[2];
         // TODO: insert warping here
-        Vector rgb = Magnitude2RGB(so.mag);
-        m_gl.DrawRGBStar(n_vbs, rgb);
+        float* s = &m_starPacked[4*i];
+        s[0] = (float)  n_vbs[0];
+        s[1] = (float) -n_vbs[1];
+        s[2] = (float) -n_vbs[2];
+        s[3] = (float) m_sky.m_mag[k];
     }
+    m_gl.SplatStars(m_starPacked.data(), N);
 }
 
 void OpticalStimulator::RenderQuat(const Vector& q_eci2vbs){
+    ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_FRAME, true);
     m_gl.ClearScreen();
     DrawSO(q_eci2vbs);
     m_gl.SwapBuffers();
@@ -159,22 +272,194 @@ void OpticalStimulator::FarRangeAON(Matrix& so_vbs, Matrix& so_rgb, Matrix& nso_
     m_gl.ClearScreen();
 
     // render SO
-    for(int i=0; i < so_vbs.nRows(); i++)
-        m_gl.DrawRGBStar(so_vbs.Row(i), so_rgb.Row(i));
+    m_gl.DrawStars(so_vbs, so_rgb);
     
     // render NSO
-    for(int i=0; i < nso_vbs.nRows(); i++)
-        m_gl.DrawRGBStar(nso_vbs.Row(i), nso_rgb.Row(i));
+    m_gl.DrawStars(nso_vbs, nso_rgb);
         
     // swap buffers
     m_gl.SwapBuffers();
 }
 
 void OpticalStimulator::RenderTango(const S3& s3){
-    
+    ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_FRAME, true);
+
     // reset screen
     m_gl.ClearScreen();
     
+    DrawTango(s3);
+        
+    // Swap Buffers
+    m_gl.SwapBuffers();
+}
+
+void OpticalStimulator::RenderTangoBatch(const std::vector<S3>& states, std::vector<unsigned char>& frames){
+
+    size_t frameBytes = (size_t) m_gl.OutputChannels() * m_gl.OutputWidth() * m_gl.OutputHeight();
+    frames.resize(states.size() * frameBytes);
+    m_frameRegions.resize(4 * states.size());
+    m_frameKeypoints.clear();
+    std::vector<uint16_t> masks;
+    std::vector<float> depths;
+    size_t framePixels = (size_t) m_gl.m_camera.Nu * m_gl.m_camera.Nv;
+    if (m_gl.m_labelsOn){
+        masks.resize(states.size() * framePixels);
+        depths.resize(states.size() * framePixels);
+    }
+
+    // render in chunks of at most one layered framebuffer
+    size_t first = 0;
+    while (first < states.size()){
+        int N = m_gl.BeginBatch((int) (states.size() - first));
+        for (int i = 0; i < N; i++){
+            ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_FRAME, true);
+            m_gl.BeginBatchFrame(i);
+            m_gl.ClearScreen();
+            DrawTango(states[first + i]);
+            m_frameKeypoints.insert(m_frameKeypoints.end(), m_keypointsUV.begin(), m_keypointsUV.end());
+        }
+        m_gl.EndBatch(N, &frames[first * frameBytes]);
+        std::copy(m_gl.m_regions.begin(), m_gl.m_regions.begin() + 4*N, m_frameRegions.begin() + 4*first);
+        if (m_gl.m_labelsOn){
+            std::copy(m_gl.m_labelMask.begin(), m_gl.m_labelMask.begin() + N*framePixels, masks.begin() + first*framePixels);
+            std::copy(m_gl.m_labelDepth.begin(), m_gl.m_labelDepth.begin() + N*framePixels, depths.begin() + first*framePixels);
+        }
+        first += N;
+    }
+
+    // labels of the whole call, in state order
+    if (m_gl.m_labelsOn){
+        m_gl.m_labelMask.swap(masks);
+        m_gl.m_labelDepth.swap(depths);
+    }
+}
+
+void OpticalStimulator::RenderTangoBatch(const std::vector<S3>& states, const std::vector<std::string>& filenames){
+
+    if (filenames.size() != states.size())
+        throw std::runtime_error("RenderTangoBatch: number of filenames does not match number of states\n");
+
+    std::vector<unsigned char> frames;
+    RenderTangoBatch(states, frames);
+
+    // encode on the writer pool, each frame gets its own pooled buffer
+    size_t frameBytes = (size_t) m_gl.OutputChannels() * m_gl.OutputWidth() * m_gl.OutputHeight();
+    for (size_t i = 0; i < states.size(); i++){
+        ReadbackFrame frame;
+        frame.filename = filenames[i];
+        frame.pixels = m_gl.m_readback.m_pool.Acquire(frameBytes);
+        frame.width = m_gl.OutputWidth();
+        frame.height = m_gl.OutputHeight();
+        frame.channels = m_gl.OutputChannels();
+        std::memcpy(frame.pixels.data(), &frames[i * frameBytes], frameBytes);
+        m_gl.WriteFrame(frame);
+    }
+}
+
+void OpticalStimulator::RenderTangoBatch(const std::vector<S3>& states, const std::vector<int64_t>& rows,
+                                         ShardWriter& writer){
+
+    if (rows.size() != states.size())
+        throw std::runtime_error("RenderTangoBatch: number of rows does not match number of states\n");
+
+    // "image" (uint8 {height, width, channels}), then any of the label tensors
+    //   "mask" uint16 {Nv, Nu, 1}, "depth" float32 {Nv, Nu, 1}, "keypoints" float32 {K, 3}
+    const std::vector<TensorSpec>& tensors = writer.Tensors();
+    bool valid = !tensors.empty() && tensors[0].name == "image" && tensors[0].type == TENSOR_UINT8 &&
+                 tensors[0].shape.size() == 3 && tensors[0].shape[0] == m_gl.OutputHeight() &&
+                 tensors[0].shape[1] == m_gl.OutputWidth() && tensors[0].shape[2] == m_gl.OutputChannels();
+    for (size_t t = 1; t < tensors.size() && valid; t++){
+        const TensorSpec& spec = tensors[t];
+        bool plane = spec.shape.size() == 3 && spec.shape[0] == m_gl.m_camera.Nv && spec.shape[1] == m_gl.m_camera.Nu &&
+                     spec.shape[2] == 1;
+        if (spec.name == "mask")
+            valid = m_gl.m_labelsOn && spec.type == TENSOR_UINT16 && plane;
+        else if (spec.name == "depth")
+            valid = m_gl.m_labelsOn && spec.type == TENSOR_FLOAT32 && plane;
+        else if (spec.name == "keypoints")
+            valid = m_gl.m_labelsOn && spec.type == TENSOR_FLOAT32 && spec.shape.size() == 2 && spec.shape[1] == 3;
+        else
+            valid = false;
+    }
+    if (!valid)
+        throw std::runtime_error("RenderTangoBatch: shard schema must be a uint8 {height, width, channels} image "
+                                 "followed by labels (mask, depth, keypoints) rendered with SetLabels\n");
+
+    std::vector<unsigned char> frames;
+    RenderTangoBatch(states, frames);
+
+    // raw frames straight into the shard, no encode
+    std::vector<const void*> data(tensors.size());
+    for (size_t i = 0; i < states.size(); i++){
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_WRITE);
+        for (size_t t = 0; t < tensors.size(); t++){
+            size_t bytes = tensors[t].Bytes();
+            if (tensors[t].name == "image")
+                data[t] = &frames[i * bytes];
+            else if (tensors[t].name == "mask")
+                data[t] = &m_gl.m_labelMask[i * bytes / sizeof(uint16_t)];
+            else if (tensors[t].name == "depth")
+                data[t] = &m_gl.m_labelDepth[i * bytes / sizeof(float)];
+            else{
+                if (m_frameKeypoints.size() != states.size() * bytes / sizeof(float))
+                    throw std::runtime_error("RenderTangoBatch: shard schema does not match the number of keypoints\n");
+                data[t] = &m_frameKeypoints[i * bytes / sizeof(float)];
+            }
+        }
+        if (!writer.Write(rows[i], data))
+            throw std::runtime_error("RenderTangoBatch: cannot write " + writer.ShardPath() + "\n");
+    }
+}
+
+bool OpticalStimulator::RenderTiled(TiledFrame& frame, const std::function<void()>& draw){
+
+    // one tile of pixels at a time, the frame itself only holds the current tile row
+    int T = m_gl.TileSize();
+    std::vector<unsigned char> pixels((size_t) 3 * T * T);
+    for (int i = 0; i < frame.Tiles(); i++){
+        {
+            ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_FRAME, true);
+            m_gl.BeginTile(frame.GetTile(i));
+            m_gl.ClearScreen();
+            draw();
+            m_gl.EndTile(pixels.data());
+        }
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_WRITE);
+        if (!frame.Put(i, pixels.data())){
+            frame.Close();
+            return false;
+        }
+    }
+    return frame.Close();
+}
+
+bool OpticalStimulator::RenderTangoTiled(const S3& s3, const std::string& filename){
+    TiledFrame frame;
+    int T = m_gl.TileSize();
+    if (!frame.OpenFile(filename, m_gl.m_camera.Nu, m_gl.m_camera.Nv, 3, T, T))
+        return false;
+    return RenderTiled(frame, [&](){ DrawTango(s3); });
+}
+
+bool OpticalStimulator::RenderTangoTiled(const S3& s3, std::vector<unsigned char>& pixels){
+    TiledFrame frame;
+    int T = m_gl.TileSize();
+    pixels.resize((size_t) 3 * m_gl.m_camera.Nu * m_gl.m_camera.Nv);
+    if (!frame.OpenBuffer(pixels.data(), m_gl.m_camera.Nu, m_gl.m_camera.Nv, 3, T, T))
+        return false;
+    return RenderTiled(frame, [&](){ DrawTango(s3); });
+}
+
+bool OpticalStimulator::RenderQuatTiled(const Vector& q_eci2vbs, const std::string& filename){
+    TiledFrame frame;
+    int T = m_gl.TileSize();
+    if (!frame.OpenFile(filename, m_gl.m_camera.Nu, m_gl.m_camera.Nv, 3, T, T))
+        return false;
+    return RenderTiled(frame, [&](){ DrawSO(q_eci2vbs); });
+}
+
+void OpticalStimulator::DrawTango(const S3& s3){
+
     // Update Sun
     m_gl.m_sun.r_vbs = s3.r_Vo2So_vbs;
     m_gl.m_sun.on = true;
@@ -182,21 +467,32 @@ void OpticalStimulator::RenderTango(const S3& s3){
     // Draw TANGO
     m_gl.m_tango.r_vbs = s3.r_Vo2To_vbs;
     m_gl.m_tango.q_vbs2body = s3.q_vbs2tango;
-    m_gl.DrawCAD(m_gl.m_tango);
+    {
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_DRAW_TANGO, true);
+        m_gl.DrawCAD(m_gl.m_tango);
+    }
+    m_gl.MarkROI(m_gl.m_tango);
+    if (m_gl.m_labelsOn){
+        m_gl.DrawLabels(m_gl.m_tango, 1);
+        ProjectKeypoints(m_gl.m_tango);
+    }
     
     // Draw TANGO triad
     m_gl.m_triad.r_vbs = m_gl.m_tango.r_vbs;
     m_gl.m_triad.q_vbs2body = m_gl.m_tango.q_vbs2body;
-    m_gl.DrawCAD(m_gl.m_triad);
+    {
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_DRAW_TRIAD, true);
+        m_gl.DrawCAD(m_gl.m_triad);
+    }
     
     // Draw Earth
     m_gl.m_earth.r_vbs = s3.r_Vo2Eo_vbs;
     m_gl.m_earth.q_vbs2body = s3.q_vbs2ecef;
-    m_gl.DrawCAD(m_gl.m_earth);
+    {
+        ProfileScope profile(m_gl.m_profiler, Profiler::STAGE_DRAW_EARTH, true);
+        m_gl.DrawCAD(m_gl.m_earth);
+    }
 
     // render SO
     DrawSO(s3.q_eci2vbs);
-        
-    // Swap Buffers
-    m_gl.SwapBuffers();
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+// OS_POSETABLE.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: pose tables driving batch rendering, one row per frame,
+//              as CSV or as a little-endian binary file
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_posetable.hpp"
+
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char MAGIC[4] = {'O', 'S', 'P', 'T'};
+
+static bool IsBinary(const std::string& path){
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+}
+
+PoseTable::PoseTable() :
+    m_nRows(0),
+    m_nCols(0)
+{
+}
+
+void PoseTable::Resize(int nRows, int nCols){
+    m_nRows = nRows;
+    m_nCols = nCols;
+    m_data.assign((size_t) nRows*nCols, 0.0);
+}
+
+bool PoseTable::Load(const std::string& path){
+
+    Resize(0, 0);
+
+    if (IsBinary(path)){
+        std::ifstream in(path.c_str(), std::ios::binary);
+        char magic[4];
+        uint32_t version = 0, nCols = 0;
+        uint64_t nRows = 0;
+        in.read(magic, 4);
+        in.read((char*) &version, sizeof(version));
+        in.read((char*) &nCols, sizeof(nCols));
+        in.read((char*) &nRows, sizeof(nRows));
+        if (!in || std::memcmp(magic, MAGIC, 4) != 0 || version != VERSION || nCols < POSE_COLS_TANGO){
+            std::cout << "PoseTable: not a pose table: " << path << std::endl;
+            return false;
+        }
+
+        // the header must describe exactly the data that follows, before anything is allocated
+        std::streamoff header = in.tellg();
+        in.seekg(0, std::ios::end);
+        uint64_t dataBytes = (uint64_t) (in.tellg() - header);
+        in.seekg(header);
+        if (nCols > INT_MAX || nRows > INT_MAX || nRows*nCols > (uint64_t) INT_MAX ||
+            dataBytes != sizeof(double)*nRows*nCols){
+            std::cout << "PoseTable: " << nRows << " x " << nCols << " does not match the size of " << path << std::endl;
+            return false;
+        }
+        Resize((int) nRows, (int) nCols);
+        in.read((char*) m_data.data(), sizeof(double)*m_data.size());
+        if (!in){
+            std::cout << "PoseTable: truncated file " << path << std::endl;
+            Resize(0, 0);
+            return false;
+        }
+        return true;
+    }
+
+    std::ifstream in(path.c_str());
+    if (!in){
+        std::cout << "PoseTable: cannot open " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)){
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#' || std::isalpha((unsigned char) line[start]))
+            continue;
+
+        std::vector<double> row;
+        const char* p = line.c_str() + start;
+        while (*p != '\0' && *p != '\r'){
+            char* end;
+            double value = std::strtod(p, &end);
+            if (end == p){
+                std::cout << "PoseTable: bad value at " << path << ":" << lineNumber << std::endl;
+                Resize(0, 0);
+                return false;
+            }
+            row.push_back(value);
+            p = end;
+
+            // one separator: blanks, or a comma with optional blanks around it; a comma
+            // followed by another comma or the end of the line is an empty field
+            while (*p == ' ' || *p == '\t')
+                p++;
+            if (*p == ','){
+                p++;
+                while (*p == ' ' || *p == '\t')
+                    p++;
+                if (*p == ',' || *p == '\0' || *p == '\r'){
+                    std::cout << "PoseTable: empty field at " << path << ":" << lineNumber << std::endl;
+                    Resize(0, 0);
+                    return false;
+                }
+            }
+        }
+
+        if (m_nCols == 0)
+            m_nCols = (int) row.size();
+        if ((int) row.size() != m_nCols || m_nCols < POSE_COLS_TANGO){
+            std::cout << "PoseTable: expected " << (m_nCols < POSE_COLS_TANGO ? POSE_COLS_TANGO : m_nCols)
+                      << " columns at " << path << ":" << lineNumber << std::endl;
+            Resize(0, 0);
+            return false;
+        }
+        m_data.insert(m_data.end(), row.begin(), row.end());
+        m_nRows++;
+    }
+    return true;
+}
+
+bool PoseTable::Save(const std::string& path) const{
+
+    if (IsBinary(path)){
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        uint32_t version = VERSION, nCols = m_nCols;
+        uint64_t nRows = m_nRows;
+        out.write(MAGIC, 4);
+        out.write((const char*) &version, sizeof(version));
+        out.write((const char*) &nCols, sizeof(nCols));
+        out.write((const char*) &nRows, sizeof(nRows));
+        out.write((const char*) m_data.data(), sizeof(double)*m_data.size());
+        return (bool) out;
+    }
+
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL)
+        return false;
+    fprintf(f, "# r_Vo2To_vbs(3), q_vbs2tango(4), r_Vo2So_vbs(3)%s\n",
+            HasFull() ? ", q_eci2vbs(4), r_Vo2Eo_vbs(3), q_vbs2ecef(4)" : "");
+    for (int i = 0; i < m_nRows; i++){
+        const double* row = Row(i);
+        for (int j = 0; j < m_nCols; j++)
+            fprintf(f, j == 0 ? "%.17g" : ",%.17g", row[j]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
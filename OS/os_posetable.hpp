@@ -0,0 +1,58 @@
+// OS_POSETABLE.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: pose tables driving batch rendering, one row per frame,
+//              as CSV or as a little-endian binary file
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_POSETABLE_HPP
+#define OS_POSETABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// columns, all in the VBS frame:
+//    0.. 2  r_Vo2To_vbs    Tango position [m]
+//    3.. 6  q_vbs2tango    Tango attitude (scalar first)
+//    7.. 9  r_Vo2So_vbs    sun direction
+//   optional (POSE_COLS_FULL):
+//   10..13  q_eci2vbs      camera attitude for the star field
+//   14..16  r_Vo2Eo_vbs    Earth position [m]
+//   17..20  q_vbs2ecef     Earth attitude
+//
+// CSV: one row per line, comma separated; lines starting with '#' or a letter (header) are skipped
+// binary (.bin): "OSPT", uint32 version, uint32 nCols, uint64 nRows, nRows*nCols doubles row-major
+class PoseTable
+{
+public:
+    static const int POSE_COLS_TANGO = 10;
+    static const int POSE_COLS_FULL = 21;
+    static const uint32_t VERSION = 1;
+
+    PoseTable();
+
+    // format chosen by extension (.bin = binary, anything else = CSV); false on any error
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    int Rows() const                        { return m_nRows; };
+    int Cols() const                        { return m_nCols; };
+    const double* Row(int i) const          { return &m_data[(size_t) i*m_nCols]; };
+    bool HasFull() const                    { return m_nCols >= POSE_COLS_FULL; };
+
+    void Resize(int nRows, int nCols);
+    double* Row(int i)                      { return &m_data[(size_t) i*m_nCols]; };
+
+private:
+    int m_nRows;
+    int m_nCols;
+    std::vector<double> m_data;
+};
+
+#endif
@@ -0,0 +1,385 @@
+// OS_POSTPROCESS.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GPU post-process before readback: area-filtered resize of
+//              a source region (full frame or a crop around the target),
+//              optional RGB to luma reduction and camera sensor model
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_postprocess.hpp"
+#include "os_glprogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// full-screen triangle from gl_VertexID, no vertex buffer
+static const char* POST_VS = R"(
+#version 330 core
+void main()
+{
+    vec2 p = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    gl_Position = vec4(p, 0.0, 1.0);
+}
+)";
+
+static const char* POST_FS = R"(
+#version 330 core
+uniform sampler2DArray source;
+uniform float layer;
+uniform vec2 origin;        // region lower-left [source pixels]
+uniform vec2 extent;        // region size [source pixels]
+uniform vec2 sourceSize;
+uniform vec2 targetSize;
+uniform int taps;           // per axis
+uniform int luma;
+uniform int blurRadius;     // [output pixels], 0 = no optics blur
+uniform float blurSigma;
+uniform int sensor;
+uniform float focal;        // [source pixels]
+uniform float vignetting;
+uniform vec4 electrons;     // full well, read noise, dark signal [e-], ADC levels
+uniform uvec2 key;          // frame key, seed
+out vec4 FragColor;
+
+// footprint of the output pixel with lower-left corner q in the source, sampled on a taps x taps
+// grid of bilinear fetches (each averages 2x2 texels): a box filter over the footprint
+vec3 Footprint(vec2 q)
+{
+    vec2 footprint = extent / targetSize;
+    vec2 base = origin + q * footprint;
+    vec2 step = footprint / float(taps);
+    vec3 sum = vec3(0.0);
+    for (int j = 0; j < taps; j++)
+        for (int i = 0; i < taps; i++){
+            vec2 p = base + (vec2(i, j) + 0.5) * step;
+            sum += texture(source, vec3(p / sourceSize, layer)).rgb;
+        }
+    return sum / float(taps * taps);
+}
+
+// counter-based hash (pcg4d, Jarzynski & Olano 2020): same counter, same numbers
+uvec4 Pcg4d(uvec4 v)
+{
+    v = v * 1664525u + 1013904223u;
+    v.x += v.y * v.w; v.y += v.z * v.x; v.z += v.x * v.y; v.w += v.y * v.z;
+    v ^= v >> 16u;
+    v.x += v.y * v.w; v.y += v.z * v.x; v.z += v.x * v.y; v.w += v.y * v.z;
+    return v;
+}
+
+// two pairs of standard normals from one hash (Box-Muller on 24-bit uniforms)
+vec4 Normals(uvec4 h)
+{
+    vec4 u = vec4(h >> 8u) * (1.0 / 16777216.0);
+    vec2 r = sqrt(-2.0 * log(1.0 - u.xz));
+    vec2 a = 6.28318531 * u.yw;
+    return vec4(r.x * cos(a.x), r.x * sin(a.x), r.y * cos(a.y), r.y * sin(a.y));
+}
+
+void main()
+{
+    vec2 q = gl_FragCoord.xy - 0.5;
+    vec3 c;
+    if (blurRadius == 0)
+        c = Footprint(q);
+    else {
+        // optics PSF: Gaussian over the neighbouring output pixels
+        c = vec3(0.0);
+        float sum = 0.0;
+        for (int j = -blurRadius; j <= blurRadius; j++)
+            for (int i = -blurRadius; i <= blurRadius; i++){
+                float w = exp(-0.5 * float(i*i + j*j) / (blurSigma * blurSigma));
+                c += w * Footprint(q + vec2(i, j));
+                sum += w;
+            }
+        c /= sum;
+    }
+    if (luma != 0)
+        c = vec3(dot(c, vec3(0.299, 0.587, 0.114)));
+
+    if (sensor != 0){
+        // cos^4 of the field angle of this pixel's center in the camera frame
+        vec2 d = origin + (q + 0.5) * extent / targetSize - 0.5 * sourceSize;
+        float cos2 = focal * focal / (focal * focal + dot(d, d));
+        c *= mix(1.0, cos2 * cos2, vignetting);
+
+        // signal and dark electrons with shot noise (Gaussian, variance = mean) and read noise, then the ADC
+        uvec4 h = Pcg4d(uvec4(uvec2(gl_FragCoord.xy), key));
+        vec4 n0 = Normals(h), n1 = Normals(Pcg4d(h));
+        vec3 e = c * electrons.x + electrons.z;
+        e += sqrt(max(e, 0.0)) * vec3(n0.xy, n1.x) + electrons.y * vec3(n0.zw, n1.y);
+        c = clamp(floor(e / electrons.x * electrons.w + 0.5), 0.0, electrons.w) / electrons.w;
+    }
+    FragColor = vec4(c, 1.0);
+}
+)";
+
+// shader uniforms of the sensor model
+static int BlurRadius(const SensorSettings& sensor){
+    if (!sensor.on || sensor.blurSigma <= 0.0f)
+        return 0;
+    return std::min(8, (int) std::ceil(3.0f * sensor.blurSigma));
+}
+
+static float Levels(const SensorSettings& sensor){
+    return (float) ((1 << std::min(8, std::max(1, sensor.bits))) - 1);
+}
+
+PostProcess::PostProcess() :
+    m_initialized(false),
+    m_program(0),
+    m_VAO(0)
+{
+}
+
+bool PostProcess::Create(){
+
+    Delete();
+
+    m_program = CompileProgram(POST_VS, POST_FS, "postprocess");
+    if (m_program == 0)
+        return false;
+    m_locLayer = glGetUniformLocation(m_program, "layer");
+    m_locOrigin = glGetUniformLocation(m_program, "origin");
+    m_locExtent = glGetUniformLocation(m_program, "extent");
+    m_locSourceSize = glGetUniformLocation(m_program, "sourceSize");
+    m_locTargetSize = glGetUniformLocation(m_program, "targetSize");
+    m_locTaps = glGetUniformLocation(m_program, "taps");
+    m_locLuma = glGetUniformLocation(m_program, "luma");
+    m_locBlurRadius = glGetUniformLocation(m_program, "blurRadius");
+    m_locBlurSigma = glGetUniformLocation(m_program, "blurSigma");
+    m_locSensor = glGetUniformLocation(m_program, "sensor");
+    m_locFocal = glGetUniformLocation(m_program, "focal");
+    m_locVignetting = glGetUniformLocation(m_program, "vignetting");
+    m_locElectrons = glGetUniformLocation(m_program, "electrons");
+    m_locKey = glGetUniformLocation(m_program, "key");
+    glUseProgram(m_program);
+    glUniform1i(glGetUniformLocation(m_program, "source"), 0);
+    glUseProgram(0);
+
+    // core profile draws need a vertex array object, even an empty one
+    glGenVertexArrays(1, &m_VAO);
+
+    m_initialized = true;
+    return true;
+}
+
+void PostProcess::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteProgram(m_program);
+    m_VAO = 0;
+    m_program = 0;
+    m_initialized = false;
+}
+
+// leaves its program, vertex array and texture bindings behind (RenderState must be invalidated)
+void PostProcess::Run(GLuint sourceArray, int sourceLayer, int sourceWidth, int sourceHeight, const float region[4],
+                      bool luma, Framebuffer& target, int targetLayer,
+                      const SensorSettings& sensor, float focal, unsigned int key){
+
+    if (!m_initialized && !Create())
+        return;
+
+    float extent[2] = {region[2] - region[0], region[3] - region[1]};
+    float footprint = std::max(extent[0] / target.m_width, extent[1] / target.m_height);
+    int taps = std::min(8, std::max(1, (int) std::ceil(0.5f * footprint)));
+
+    // filtered reads, black outside the frame
+    const float BLACK[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, sourceArray);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, BLACK);
+
+    target.BindLayer(targetLayer);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glUseProgram(m_program);
+    glUniform1f(m_locLayer, (float) sourceLayer);
+    glUniform2f(m_locOrigin, region[0], region[1]);
+    glUniform2f(m_locExtent, extent[0], extent[1]);
+    glUniform2f(m_locSourceSize, (float) sourceWidth, (float) sourceHeight);
+    glUniform2f(m_locTargetSize, (float) target.m_width, (float) target.m_height);
+    glUniform1i(m_locTaps, taps);
+    glUniform1i(m_locLuma, luma ? 1 : 0);
+    glUniform1i(m_locBlurRadius, BlurRadius(sensor));
+    glUniform1f(m_locBlurSigma, sensor.blurSigma);
+    glUniform1i(m_locSensor, sensor.on ? 1 : 0);
+    glUniform1f(m_locFocal, focal);
+    glUniform1f(m_locVignetting, sensor.vignetting);
+    glUniform4f(m_locElectrons, sensor.fullWell, sensor.readNoise, sensor.darkCurrent * sensor.exposure, Levels(sensor));
+    glUniform2ui(m_locKey, key, sensor.seed);
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+
+    // sampling state is per texture: leave the render target as it was created
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+// GL_LINEAR fetch with a black border, as Run samples the source
+static void Bilinear(const unsigned char* source, int width, int height, float x, float y, float rgb[3]){
+
+    float fx = x - 0.5f, fy = y - 0.5f;
+    int x0 = (int) std::floor(fx), y0 = (int) std::floor(fy);
+    float ax = fx - x0, ay = fy - y0;
+    rgb[0] = rgb[1] = rgb[2] = 0.0f;
+    for (int j = 0; j < 2; j++)
+        for (int i = 0; i < 2; i++){
+            int xi = x0 + i, yj = y0 + j;
+            if (xi < 0 || yj < 0 || xi >= width || yj >= height)
+                continue;
+            float w = (i ? ax : 1.0f - ax) * (j ? ay : 1.0f - ay);
+            const unsigned char* p = source + 3*((size_t) yj * width + xi);
+            for (int c = 0; c < 3; c++)
+                rgb[c] += w * p[c];
+        }
+}
+
+// box filter over the footprint of output pixel (x, y), as Footprint in the shader
+static void Footprint(const unsigned char* source, int sourceWidth, int sourceHeight, const float region[4],
+                      const float footprint[2], int taps, int x, int y, float sum[3]){
+
+    float rgb[3];
+    sum[0] = sum[1] = sum[2] = 0.0f;
+    for (int j = 0; j < taps; j++)
+        for (int i = 0; i < taps; i++){
+            float px = region[0] + (x + (i + 0.5f) / taps) * footprint[0];
+            float py = region[1] + (y + (j + 0.5f) / taps) * footprint[1];
+            Bilinear(source, sourceWidth, sourceHeight, px, py, rgb);
+            for (int c = 0; c < 3; c++)
+                sum[c] += rgb[c];
+        }
+    for (int c = 0; c < 3; c++)
+        sum[c] /= taps * taps;
+}
+
+static void Pcg4d(uint32_t v[4]){
+    for (int i = 0; i < 4; i++)
+        v[i] = v[i] * 1664525u + 1013904223u;
+    v[0] += v[1] * v[3]; v[1] += v[2] * v[0]; v[2] += v[0] * v[1]; v[3] += v[1] * v[2];
+    for (int i = 0; i < 4; i++)
+        v[i] ^= v[i] >> 16;
+    v[0] += v[1] * v[3]; v[1] += v[2] * v[0]; v[2] += v[0] * v[1]; v[3] += v[1] * v[2];
+}
+
+static void Normals(const uint32_t h[4], float n[4]){
+    for (int k = 0; k < 2; k++){
+        float u0 = (h[2*k] >> 8) * (1.0f / 16777216.0f), u1 = (h[2*k + 1] >> 8) * (1.0f / 16777216.0f);
+        float r = std::sqrt(-2.0f * std::log(1.0f - u0)), a = 6.28318531f * u1;
+        n[2*k] = r * std::cos(a);
+        n[2*k + 1] = r * std::sin(a);
+    }
+}
+
+void PostProcess::RunCPU(const unsigned char* source, int sourceWidth, int sourceHeight, const float region[4],
+                         bool luma, int targetWidth, int targetHeight, unsigned char* target,
+                         const SensorSettings& sensor, float focal, unsigned int key){
+
+    float extent[2] = {region[2] - region[0], region[3] - region[1]};
+    float footprint[2] = {extent[0] / targetWidth, extent[1] / targetHeight};
+    int taps = std::min(8, std::max(1, (int) std::ceil(0.5f * std::max(footprint[0], footprint[1]))));
+    int channels = luma ? 1 : 3;
+    int blurRadius = BlurRadius(sensor);
+    float levels = Levels(sensor), dark = sensor.darkCurrent * sensor.exposure;
+
+    for (int y = 0; y < targetHeight; y++)
+        for (int x = 0; x < targetWidth; x++){
+            float sum[3], rgb[3];
+            if (blurRadius == 0)
+                Footprint(source, sourceWidth, sourceHeight, region, footprint, taps, x, y, sum);
+            else {
+                float weights = 0.0f;
+                sum[0] = sum[1] = sum[2] = 0.0f;
+                for (int j = -blurRadius; j <= blurRadius; j++)
+                    for (int i = -blurRadius; i <= blurRadius; i++){
+                        float w = std::exp(-0.5f * (i*i + j*j) / (sensor.blurSigma * sensor.blurSigma));
+                        Footprint(source, sourceWidth, sourceHeight, region, footprint, taps, x + i, y + j, rgb);
+                        for (int c = 0; c < 3; c++)
+                            sum[c] += w * rgb[c];
+                        weights += w;
+                    }
+                for (int c = 0; c < 3; c++)
+                    sum[c] /= weights;
+            }
+            if (luma)
+                sum[0] = 0.299f*sum[0] + 0.587f*sum[1] + 0.114f*sum[2];
+
+            if (sensor.on){
+                float dx = region[0] + (x + 0.5f) * footprint[0] - 0.5f * sourceWidth;
+                float dy = region[1] + (y + 0.5f) * footprint[1] - 0.5f * sourceHeight;
+                float cos2 = focal * focal / (focal * focal + dx * dx + dy * dy);
+                float v = 1.0f + sensor.vignetting * (cos2 * cos2 - 1.0f);
+
+                uint32_t h[4] = {(uint32_t) x, (uint32_t) y, key, sensor.seed};
+                float n0[4], n1[4];
+                Pcg4d(h);
+                Normals(h, n0);
+                Pcg4d(h);
+                Normals(h, n1);
+                const float shot[3] = {n0[0], n0[1], n1[0]}, read[3] = {n0[2], n0[3], n1[1]};
+                for (int c = 0; c < channels; c++){
+                    float e = sum[c] / 255.0f * v * sensor.fullWell + dark;
+                    e += std::sqrt(std::max(e, 0.0f)) * shot[c] + sensor.readNoise * read[c];
+                    float dn = std::min(levels, std::max(0.0f, std::floor(e / sensor.fullWell * levels + 0.5f)));
+                    sum[c] = dn / levels * 255.0f;
+                }
+            }
+
+            unsigned char* out = target + channels * ((size_t) y * targetWidth + x);
+            for (int c = 0; c < channels; c++)
+                out[c] = (unsigned char) std::min(255.0f, sum[c] + 0.5f);
+        }
+}
+
+void PostProcess::FrameRegion(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight, float region[4]){
+
+    float w = (float) sourceWidth, h = (float) sourceHeight;
+    if (w * targetHeight > h * targetWidth)
+        w = h * targetWidth / targetHeight;
+    else
+        h = w * targetHeight / targetWidth;
+    region[0] = 0.5f * (sourceWidth - w);
+    region[1] = 0.5f * (sourceHeight - h);
+    region[2] = region[0] + w;
+    region[3] = region[1] + h;
+}
+
+void PostProcess::BoxRegion(const float box[4], float margin, int targetWidth, int targetHeight, float region[4]){
+
+    float cx = 0.5f * (box[0] + box[2]), cy = 0.5f * (box[1] + box[3]);
+    float w = (box[2] - box[0]) * (1.0f + margin);
+    float h = (box[3] - box[1]) * (1.0f + margin);
+
+    // grow the short side to the target aspect, then to at least one source pixel per output pixel
+    float aspect = (float) targetWidth / targetHeight;
+    if (w < h * aspect)
+        w = h * aspect;
+    else
+        h = w / aspect;
+    if (w < targetWidth){
+        w = (float) targetWidth;
+        h = (float) targetHeight;
+    }
+    region[0] = cx - 0.5f * w;
+    region[1] = cy - 0.5f * h;
+    region[2] = cx + 0.5f * w;
+    region[3] = cy + 0.5f * h;
+}
@@ -0,0 +1,100 @@
+// OS_POSTPROCESS.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GPU post-process before readback: area-filtered resize of
+//              a source region (full frame or a crop around the target),
+//              optional RGB to luma reduction and camera sensor model
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_POSTPROCESS_HPP
+#define OS_POSTPROCESS_HPP
+
+#include "include/glad/glad.h"
+#include "os_framebuffer.hpp"
+
+// what the readback delivers, width/height 0 = camera size
+struct OutputSettings
+{
+    int width;
+    int height;
+    bool luma;                  // Rec.601 luma, one channel
+    bool roi;                   // crop around the projected bounds marked with GL::MarkROI
+    float roiMargin;            // ROI grown by this fraction of its size
+
+    OutputSettings() : width(0), height(0), luma(false), roi(false), roiMargin(0.1f) {};
+};
+
+// detector between the rendered image (linear, 1 = full well) and the output pixels, which are
+// the detector pixels: optics blur, vignetting, shot / read / dark noise and the ADC, fused into
+// the post-process pass. Noise comes from a counter-based hash of (pixel, frame key, seed), so a
+// frame is reproducible on its own, whatever was rendered before it
+struct SensorSettings
+{
+    bool on;
+    float blurSigma;            // optics PSF [output pixels], 0 = none
+    float vignetting;           // 0 = none, 1 = natural cos^4 falloff
+    float fullWell;             // [e-]
+    float readNoise;            // [e- rms]
+    float darkCurrent;          // [e-/s]
+    float exposure;             // [s]
+    int bits;                   // ADC depth, 1..8 (frames are read back as 8-bit)
+    unsigned int seed;
+
+    SensorSettings() : on(false), blurSigma(0.0f), vignetting(0.0f), fullWell(1.0e4f), readNoise(10.0f),
+                       darkCurrent(0.0f), exposure(0.2f), bits(8), seed(0) {};
+};
+
+class PostProcess
+{
+public:
+    PostProcess();
+
+    bool Create();
+    void Delete();
+
+    // source region [x0, y0, x1, y1] in source pixels (bottom-up, may extend past the frame:
+    // outside is black) into one layer of a layered target; every output pixel averages the
+    // region's footprint with up to 8x8 bilinear taps. With the sensor on, focal [source pixels]
+    // sets the vignetting field angle and key the frame's noise
+    void Run(GLuint sourceArray, int sourceLayer, int sourceWidth, int sourceHeight, const float region[4],
+             bool luma, Framebuffer& target, int targetLayer,
+             const SensorSettings& sensor = SensorSettings(), float focal = 0.0f, unsigned int key = 0);
+
+    // same filter on RGB8 frames in memory (software renderer), target bottom-up with 1 or 3 channels;
+    // the same noise counters, values agree with Run to float rounding
+    static void RunCPU(const unsigned char* source, int sourceWidth, int sourceHeight, const float region[4],
+                       bool luma, int targetWidth, int targetHeight, unsigned char* target,
+                       const SensorSettings& sensor = SensorSettings(), float focal = 0.0f, unsigned int key = 0);
+
+    // region with the target's aspect ratio: the centered full frame, or the box (x0, y0, x1, y1)
+    // grown by margin, never smaller than the target (no upsampling of small targets)
+    static void FrameRegion(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight, float region[4]);
+    static void BoxRegion(const float box[4], float margin, int targetWidth, int targetHeight, float region[4]);
+
+    bool m_initialized;
+
+private:
+    GLuint m_program;
+    GLuint m_VAO;
+    GLint m_locLayer;
+    GLint m_locOrigin;
+    GLint m_locExtent;
+    GLint m_locSourceSize;
+    GLint m_locTargetSize;
+    GLint m_locTaps;
+    GLint m_locLuma;
+    GLint m_locBlurRadius;
+    GLint m_locBlurSigma;
+    GLint m_locSensor;
+    GLint m_locFocal;
+    GLint m_locVignetting;
+    GLint m_locElectrons;
+    GLint m_locKey;
+};
+
+#endif
@@ -0,0 +1,286 @@
+// OS_PROFILER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: per-frame instrumentation of the render pipeline: CPU
+//              scoped timers and GPU timestamp queries per stage,
+//              percentile summaries, JSON and Chrome-trace export
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+static const char* STAGE_NAMES[Profiler::N_STAGES] = {
+    "frame", "clear", "draw_tango", "draw_triad", "draw_earth", "shadow", "draw_so",
+    "star_query", "swap", "readback", "encode", "write"
+};
+
+const char* Profiler::StageName(int stage){
+    return (stage >= 0 && stage < N_STAGES) ? STAGE_NAMES[stage] : "unknown";
+}
+
+Profiler::Profiler() :
+    m_enabled(false),
+    m_gpuEnabled(true),
+    m_epoch(Clock::now()),
+    m_pendingBase(0),
+    m_clockSynced(false),
+    m_gpuOffset(0.0)
+{
+    for (int d = 0; d < 2; d++)
+        for (int s = 0; s < N_STAGES; s++)
+            m_sampleCount[d][s] = 0;
+}
+
+void Profiler::Enable(bool enabled){
+    m_enabled = enabled;
+}
+
+void Profiler::Reset(){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int d = 0; d < 2; d++)
+        for (int s = 0; s < N_STAGES; s++){
+            m_samples[d][s].clear();
+            m_sampleCount[d][s] = 0;
+        }
+    m_events.clear();
+}
+
+uint32_t Profiler::ThreadIndex(){
+    // caller holds m_mutex
+    size_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (const auto& t : m_threads)
+        if (t.first == id)
+            return t.second;
+    m_threads.push_back(std::make_pair(id, (uint32_t) m_threads.size()));
+    return m_threads.back().second;
+}
+
+void Profiler::Record(int stage, bool gpu, uint32_t thread, double start, double duration){
+    // caller holds m_mutex
+    std::vector<float>& samples = m_samples[gpu ? 1 : 0][stage];
+    size_t& count = m_sampleCount[gpu ? 1 : 0][stage];
+    if (samples.size() < MAX_SAMPLES)
+        samples.push_back((float) (duration * 1e-3));
+    else
+        samples[count % MAX_SAMPLES] = (float) (duration * 1e-3);
+    count++;
+    if (m_events.size() < MAX_EVENTS){
+        Event e = {stage, gpu, thread, start, duration};
+        m_events.push_back(e);
+    }
+}
+
+void Profiler::RecordCPU(int stage, Clock::time_point t0, Clock::time_point t1){
+    if (!m_enabled)
+        return;
+    double start = std::chrono::duration<double, std::micro>(t0 - m_epoch).count();
+    double duration = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Record(stage, false, ThreadIndex(), start, duration);
+}
+
+// ------------------------------------------------------------------------
+// GPU
+// ------------------------------------------------------------------------
+GLuint Profiler::AcquireQuery(){
+    if (m_freeQueries.empty()){
+        GLuint queries[16];
+        glGenQueries(16, queries);
+        m_freeQueries.insert(m_freeQueries.end(), queries, queries + 16);
+    }
+    GLuint query = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    return query;
+}
+
+void Profiler::BeginGPU(int stage){
+    if (!m_enabled || !m_gpuEnabled)
+        return;
+
+    // GPU timestamps onto the CPU timeline, once per context
+    if (!m_clockSynced){
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        double cpuNow = std::chrono::duration<double, std::micro>(Clock::now() - m_epoch).count();
+        m_gpuOffset = cpuNow - (double) gpuNow * 1e-3;
+        m_clockSynced = true;
+    }
+
+    GPUPending pending = {stage, AcquireQuery(), 0};
+    glQueryCounter(pending.begin, GL_TIMESTAMP);
+    m_open[stage].push_back(m_pendingBase + m_pending.size());
+    m_pending.push_back(pending);
+}
+
+void Profiler::EndGPU(int stage){
+    if (m_open[stage].empty())
+        return;
+    GPUPending& pending = m_pending[m_open[stage].back() - m_pendingBase];
+    m_open[stage].pop_back();
+    pending.end = AcquireQuery();
+    glQueryCounter(pending.end, GL_TIMESTAMP);
+}
+
+void Profiler::CollectGPU(bool wait){
+    if (!m_gpuEnabled)
+        return;
+
+    // results land in submission order, stop at the first one still in flight
+    while (!m_pending.empty() && m_pending.front().end != 0){
+        GPUPending& pending = m_pending.front();
+        if (!wait){
+            GLint available = 0;
+            glGetQueryObjectiv(pending.end, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(pending.begin, GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(pending.end, GL_QUERY_RESULT, &t1);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Record(pending.stage, true, 0, (double) t0 * 1e-3 + m_gpuOffset, (double) (t1 - t0) * 1e-3);
+        }
+        m_freeQueries.push_back(pending.begin);
+        m_freeQueries.push_back(pending.end);
+        m_pending.pop_front();
+        m_pendingBase++;
+    }
+}
+
+void Profiler::DeleteQueries(){
+    for (const auto& pending : m_pending){
+        m_freeQueries.push_back(pending.begin);
+        if (pending.end != 0)
+            m_freeQueries.push_back(pending.end);
+    }
+    if (!m_freeQueries.empty())
+        glDeleteQueries((GLsizei) m_freeQueries.size(), m_freeQueries.data());
+    m_freeQueries.clear();
+    m_pendingBase += m_pending.size();
+    m_pending.clear();
+    for (int s = 0; s < N_STAGES; s++)
+        m_open[s].clear();
+    m_clockSynced = false;
+}
+
+// ------------------------------------------------------------------------
+// reports
+// ------------------------------------------------------------------------
+Profiler::Summary Profiler::Summarize(int stage, bool gpu){
+
+    std::vector<float> samples;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        samples = m_samples[gpu ? 1 : 0][stage];
+    }
+
+    Summary s = {(int) samples.size(), 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (samples.empty())
+        return s;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (float x : samples)
+        sum += x;
+    // nearest rank
+    auto Percentile = [&](double p){
+        size_t rank = (size_t) std::ceil(p * samples.size());
+        return (double) samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+    s.mean = sum / samples.size();
+    s.p50 = Percentile(0.50);
+    s.p95 = Percentile(0.95);
+    s.p99 = Percentile(0.99);
+    s.max = samples.back();
+    return s;
+}
+
+bool Profiler::WriteJSON(const std::string& path){
+
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL)
+        return false;
+    fprintf(f, "{\n  \"stages\": [");
+    bool first = true;
+    for (int d = 0; d < 2; d++)
+        for (int stage = 0; stage < N_STAGES; stage++){
+            Summary s = Summarize(stage, d == 1);
+            if (s.count == 0)
+                continue;
+            fprintf(f, "%s\n    {\"name\": \"%s\", \"domain\": \"%s\", \"count\": %d, \"mean_ms\": %.6f, "
+                       "\"p50_ms\": %.6f, \"p95_ms\": %.6f, \"p99_ms\": %.6f, \"max_ms\": %.6f}",
+                    first ? "" : ",", StageName(stage), d == 1 ? "gpu" : "cpu", s.count, s.mean,
+                    s.p50, s.p95, s.p99, s.max);
+            first = false;
+        }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path){
+
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        events = m_events;
+    }
+
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL)
+        return false;
+    fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    fprintf(f, "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"CPU\"}},\n");
+    fprintf(f, "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"GPU\"}}");
+    for (const auto& e : events)
+        fprintf(f, ",\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                   "\"pid\": %d, \"tid\": %u}",
+                StageName(e.stage), e.gpu ? "gpu" : "cpu", e.start, e.duration, e.gpu ? 1 : 0, e.thread);
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+void Profiler::Print(){
+    printf("%-12s %4s %8s %10s %10s %10s %10s %10s\n",
+           "stage", "", "count", "mean [ms]", "p50", "p95", "p99", "max");
+    for (int d = 0; d < 2; d++)
+        for (int stage = 0; stage < N_STAGES; stage++){
+            Summary s = Summarize(stage, d == 1);
+            if (s.count > 0)
+                printf("%-12s %4s %8d %10.3f %10.3f %10.3f %10.3f %10.3f\n", StageName(stage),
+                       d == 1 ? "gpu" : "cpu", s.count, s.mean, s.p50, s.p95, s.p99, s.max);
+        }
+}
+
+// ------------------------------------------------------------------------
+// ProfileScope
+// ------------------------------------------------------------------------
+ProfileScope::ProfileScope(Profiler& profiler, int stage, bool gpu) :
+    m_profiler(profiler),
+    m_stage(stage),
+    m_active(profiler.Enabled()),
+    m_gpu(gpu)
+{
+    if (!m_active)
+        return;
+    if (m_gpu)
+        m_profiler.BeginGPU(m_stage);
+    m_t0 = Profiler::Now();
+}
+
+ProfileScope::~ProfileScope(){
+    if (!m_active)
+        return;
+    m_profiler.RecordCPU(m_stage, m_t0, Profiler::Now());
+    if (m_gpu)
+        m_profiler.EndGPU(m_stage);
+}
@@ -0,0 +1,150 @@
+// OS_PROFILER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: per-frame instrumentation of the render pipeline: CPU
+//              scoped timers and GPU timestamp queries per stage,
+//              percentile summaries, JSON and Chrome-trace export
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_PROFILER_HPP
+#define OS_PROFILER_HPP
+
+#include "include/glad/glad.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Profiler
+{
+public:
+    enum Stage
+    {
+        STAGE_FRAME,            // whole RenderTango / RenderQuat
+        STAGE_CLEAR,
+        STAGE_DRAW_TANGO,
+        STAGE_DRAW_TRIAD,
+        STAGE_DRAW_EARTH,
+        STAGE_SHADOW,           // sun shadow map renders (reused maps cost nothing)
+        STAGE_DRAW_SO,
+        STAGE_STAR_QUERY,
+        STAGE_SWAP,
+        STAGE_READBACK,
+        STAGE_ENCODE,           // writer threads
+        STAGE_WRITE,            // writer threads
+        N_STAGES
+    };
+
+    static const char* StageName(int stage);
+
+    Profiler();
+
+    // off by default, every call below is a no-op then
+    void Enable(bool enabled);
+    bool Enabled() const                    { return m_enabled; };
+
+    // no GL context (software renderer): GPU stages are skipped, CPU stages still timed
+    void EnableGPU(bool enabled)            { m_gpuEnabled = enabled; };
+
+    // forget all samples and trace events (GPU queries in flight still land afterwards)
+    void Reset();
+
+    // CPU time of a stage, any thread; t0 from Now()
+    typedef std::chrono::steady_clock Clock;
+    static Clock::time_point Now()          { return Clock::now(); };
+    void RecordCPU(int stage, Clock::time_point t0, Clock::time_point t1);
+
+    // GPU time of a stage, GL thread: timestamp queries around the stage's commands
+    // (nesting is allowed); results are picked up by CollectGPU without stalling
+    void BeginGPU(int stage);
+    void EndGPU(int stage);
+    void CollectGPU(bool wait);
+
+    // GL thread, before the context goes away
+    void DeleteQueries();
+
+    // percentiles over the last MAX_SAMPLES samples of the stage [ms]
+    struct Summary
+    {
+        int count;
+        double mean, p50, p95, p99, max;
+    };
+    Summary Summarize(int stage, bool gpu);
+
+    // {"stages": [{"name", "domain", "count", "mean_ms", "p50_ms", "p95_ms", "p99_ms", "max_ms"}, ...]}
+    bool WriteJSON(const std::string& path);
+
+    // chrome://tracing / Perfetto, CPU stages on pid 0 (one row per thread), GPU stages on pid 1
+    bool WriteChromeTrace(const std::string& path);
+
+    // table of Summarize() for every stage with samples
+    void Print();
+
+private:
+    struct Event
+    {
+        int stage;
+        bool gpu;
+        uint32_t thread;
+        double start;           // [us] since m_epoch
+        double duration;        // [us]
+    };
+
+    struct GPUPending
+    {
+        int stage;
+        GLuint begin;
+        GLuint end;             // 0 until EndGPU
+    };
+
+    void Record(int stage, bool gpu, uint32_t thread, double start, double duration);
+    GLuint AcquireQuery();
+    uint32_t ThreadIndex();
+
+    static const size_t MAX_EVENTS = 1u << 20;      // trace events kept, later ones dropped
+    static const size_t MAX_SAMPLES = 1u << 18;     // per stage, ring buffer over the newest
+
+    std::atomic<bool> m_enabled;                    // toggled on the GL thread, read by writers
+    bool m_gpuEnabled;
+    const Clock::time_point m_epoch;                // fixed at construction, safe to read unlocked
+
+    std::mutex m_mutex;
+    std::vector<float> m_samples[2][N_STAGES];      // [cpu/gpu][stage], ms
+    size_t m_sampleCount[2][N_STAGES];              // recorded so far, ring position in m_samples
+    std::vector<Event> m_events;
+    std::vector<std::pair<size_t, uint32_t>> m_threads;      // std::thread::id hash -> trace row
+
+    // GL thread only
+    std::vector<GLuint> m_freeQueries;
+    std::deque<GPUPending> m_pending;
+    std::vector<size_t> m_open[N_STAGES];           // index into m_pending, innermost last
+    size_t m_pendingBase;                           // absolute index of m_pending.front()
+    bool m_clockSynced;
+    double m_gpuOffset;                             // cpu_us - gpu_us
+};
+
+// CPU stage timer for a scope, optionally with a GPU timer around the same commands
+class ProfileScope
+{
+public:
+    ProfileScope(Profiler& profiler, int stage, bool gpu = false);
+    ~ProfileScope();
+
+private:
+    Profiler& m_profiler;
+    int m_stage;
+    bool m_active;
+    bool m_gpu;
+    Profiler::Clock::time_point m_t0;
+};
+
+#endif
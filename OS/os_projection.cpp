@@ -0,0 +1,172 @@
+// OS_PROJECTION.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: bulk camera projection kernels over SoA inputs
+//              pinhole and 5x5 polynomial distortion model (AAS 11-260),
+//              AVX2 / SSE2 with a scalar tail, no temporary allocations
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_projection.hpp"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define OS_SIMD_WIDTH 4
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define OS_SIMD_WIDTH 2
+#else
+    #define OS_SIMD_WIDTH 1
+#endif
+
+// ------------------------------------------------------------------------
+// scalar reference (also handles the tail of the SIMD loops)
+// ------------------------------------------------------------------------
+
+// sum_k sum_j P[5k+j] xn^k yn^j = ((r4*xn + r3)*xn + ...) with r_k = ((P[5k+4]*yn + P[5k+3])*yn + ...)
+static inline double Polynomial5x5(const double* P, double xn, double yn){
+    double acc = 0.0;
+    for (int k = 4; k >= 0; k--){
+        const double* row = P + 5*k;
+        double r = (((row[4]*yn + row[3])*yn + row[2])*yn + row[1])*yn + row[0];
+        acc = acc*xn + r;
+    }
+    return acc;
+}
+
+static void ProjectPinholeScalar(const CameraModel& cam, const double* x, const double* y, const double* z,
+                                 int first, int N, double* u, double* v){
+    for (int i = first; i < N; i++){
+        double iz = 1.0 / z[i];
+        u[i] = cam.fpx * x[i] * iz + cam.cx;
+        v[i] = cam.fpy * y[i] * iz + cam.cy;
+    }
+}
+
+static void ProjectDistortedScalar(const CameraModel& cam, const double* x, const double* y, const double* z,
+                                   int first, int N, double* u, double* v){
+    for (int i = first; i < N; i++){
+        double iz = 1.0 / z[i];
+        double xn = x[i] * iz;
+        double yn = y[i] * iz;
+        u[i] = Polynomial5x5(cam.C, xn, yn);
+        v[i] = Polynomial5x5(cam.D, xn, yn);
+    }
+}
+
+static void BackProjectPinholeScalar(const CameraModel& cam, const double* u, const double* v,
+                                     int first, int N, double* x, double* y, double* z){
+    for (int i = first; i < N; i++){
+        double xi = (u[i] - cam.cx) / cam.fpx;
+        double yi = (v[i] - cam.cy) / cam.fpy;
+        double inorm = 1.0 / std::sqrt(xi*xi + yi*yi + 1.0);
+        x[i] = xi * inorm;
+        y[i] = yi * inorm;
+        z[i] = inorm;
+    }
+}
+
+// ------------------------------------------------------------------------
+// SIMD helpers: one vector register holds OS_SIMD_WIDTH doubles
+// ------------------------------------------------------------------------
+#if OS_SIMD_WIDTH == 4
+    typedef __m256d vd;
+    static inline vd Load(const double* p)              { return _mm256_loadu_pd(p); }
+    static inline void Store(double* p, vd a)           { _mm256_storeu_pd(p, a); }
+    static inline vd Set1(double a)                     { return _mm256_set1_pd(a); }
+    static inline vd Add(vd a, vd b)                    { return _mm256_add_pd(a, b); }
+    static inline vd Sub(vd a, vd b)                    { return _mm256_sub_pd(a, b); }
+    static inline vd Mul(vd a, vd b)                    { return _mm256_mul_pd(a, b); }
+    static inline vd Div(vd a, vd b)                    { return _mm256_div_pd(a, b); }
+    static inline vd Sqrt(vd a)                         { return _mm256_sqrt_pd(a); }
+    #if defined(__FMA__)
+    static inline vd MulAdd(vd a, vd b, vd c)           { return _mm256_fmadd_pd(a, b, c); }
+    #else
+    static inline vd MulAdd(vd a, vd b, vd c)           { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+    #endif
+#elif OS_SIMD_WIDTH == 2
+    typedef __m128d vd;
+    static inline vd Load(const double* p)              { return _mm_loadu_pd(p); }
+    static inline void Store(double* p, vd a)           { _mm_storeu_pd(p, a); }
+    static inline vd Set1(double a)                     { return _mm_set1_pd(a); }
+    static inline vd Add(vd a, vd b)                    { return _mm_add_pd(a, b); }
+    static inline vd Sub(vd a, vd b)                    { return _mm_sub_pd(a, b); }
+    static inline vd Mul(vd a, vd b)                    { return _mm_mul_pd(a, b); }
+    static inline vd Div(vd a, vd b)                    { return _mm_div_pd(a, b); }
+    static inline vd Sqrt(vd a)                         { return _mm_sqrt_pd(a); }
+    static inline vd MulAdd(vd a, vd b, vd c)           { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+#endif
+
+#if OS_SIMD_WIDTH > 1
+static inline vd Polynomial5x5(const vd* P, vd xn, vd yn){
+    vd acc = Set1(0.0);
+    for (int k = 4; k >= 0; k--){
+        const vd* row = P + 5*k;
+        vd r = MulAdd(MulAdd(MulAdd(MulAdd(row[4], yn, row[3]), yn, row[2]), yn, row[1]), yn, row[0]);
+        acc = MulAdd(acc, xn, r);
+    }
+    return acc;
+}
+#endif
+
+// ------------------------------------------------------------------------
+// public kernels
+// ------------------------------------------------------------------------
+void ProjectPinhole(const CameraModel& cam, const double* x, const double* y, const double* z, int N,
+                    double* u, double* v){
+    int i = 0;
+#if OS_SIMD_WIDTH > 1
+    vd fpx = Set1(cam.fpx), fpy = Set1(cam.fpy), cx = Set1(cam.cx), cy = Set1(cam.cy), one = Set1(1.0);
+    for (; i + OS_SIMD_WIDTH <= N; i += OS_SIMD_WIDTH){
+        vd iz = Div(one, Load(z + i));
+        Store(u + i, MulAdd(Mul(fpx, Load(x + i)), iz, cx));
+        Store(v + i, MulAdd(Mul(fpy, Load(y + i)), iz, cy));
+    }
+#endif
+    ProjectPinholeScalar(cam, x, y, z, i, N, u, v);
+}
+
+void ProjectDistorted(const CameraModel& cam, const double* x, const double* y, const double* z, int N,
+                      double* u, double* v){
+    int i = 0;
+#if OS_SIMD_WIDTH > 1
+    // broadcast the coefficients once
+    vd C[25], D[25];
+    for (int k = 0; k < 25; k++){
+        C[k] = Set1(cam.C[k]);
+        D[k] = Set1(cam.D[k]);
+    }
+    vd one = Set1(1.0);
+    for (; i + OS_SIMD_WIDTH <= N; i += OS_SIMD_WIDTH){
+        vd iz = Div(one, Load(z + i));
+        vd xn = Mul(Load(x + i), iz);
+        vd yn = Mul(Load(y + i), iz);
+        Store(u + i, Polynomial5x5(C, xn, yn));
+        Store(v + i, Polynomial5x5(D, xn, yn));
+    }
+#endif
+    ProjectDistortedScalar(cam, x, y, z, i, N, u, v);
+}
+
+void BackProjectPinhole(const CameraModel& cam, const double* u, const double* v, int N,
+                        double* x, double* y, double* z){
+    int i = 0;
+#if OS_SIMD_WIDTH > 1
+    vd ifpx = Set1(1.0 / cam.fpx), ifpy = Set1(1.0 / cam.fpy), cx = Set1(cam.cx), cy = Set1(cam.cy), one = Set1(1.0);
+    for (; i + OS_SIMD_WIDTH <= N; i += OS_SIMD_WIDTH){
+        vd xi = Mul(Sub(Load(u + i), cx), ifpx);
+        vd yi = Mul(Sub(Load(v + i), cy), ifpy);
+        vd inorm = Div(one, Sqrt(MulAdd(xi, xi, MulAdd(yi, yi, one))));
+        Store(x + i, Mul(xi, inorm));
+        Store(y + i, Mul(yi, inorm));
+        Store(z + i, inorm);
+    }
+#endif
+    BackProjectPinholeScalar(cam, u, v, i, N, x, y, z);
+}
@@ -0,0 +1,39 @@
+// OS_PROJECTION.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: bulk camera projection kernels over SoA inputs
+//              pinhole and 5x5 polynomial distortion model (AAS 11-260),
+//              AVX2 / SSE2 with a scalar tail, no temporary allocations
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_PROJECTION_HPP
+#define OS_PROJECTION_HPP
+
+struct CameraModel
+{
+    double fpx;         // focal length [pix]
+    double fpy;
+    double cx;          // principal point [pix]
+    double cy;
+    double C[25];       // u = sum C[5k+j] xn^k yn^j
+    double D[25];       // v = sum D[5k+j] xn^k yn^j
+};
+
+// pinhole: u = fpx*x/z + cx, v = fpy*y/z + cy
+void ProjectPinhole(const CameraModel& cam, const double* x, const double* y, const double* z, int N,
+                    double* u, double* v);
+
+// polynomial distortion model evaluated in Horner form
+void ProjectDistorted(const CameraModel& cam, const double* x, const double* y, const double* z, int N,
+                      double* u, double* v);
+
+// inverse pinhole: unit vectors through pixel centers
+void BackProjectPinhole(const CameraModel& cam, const double* u, const double* v, int N,
+                        double* x, double* y, double* z);
+
+#endif
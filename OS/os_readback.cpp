@@ -0,0 +1,145 @@
+// OS_READBACK.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: asynchronous pixel readback through a ring of pixel pack
+//              buffers (PBO) plus a reusable pool of CPU frame buffers
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_readback.hpp"
+
+#include <cstring>
+#include <iostream>
+
+std::vector<unsigned char> BufferPool::Acquire(size_t bytes){
+
+    std::vector<unsigned char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()){
+            buffer = std::move(m_free.back());
+            m_free.pop_back();
+        }
+    }
+    buffer.resize(bytes);
+    return buffer;
+}
+
+void BufferPool::Release(std::vector<unsigned char>&& buffer){
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(buffer));
+}
+
+PixelReadback::PixelReadback() :
+    m_width(0),
+    m_height(0),
+    m_channels(3),
+    m_initialized(false),
+    m_oldest(0),
+    m_pending(0)
+{
+}
+
+bool PixelReadback::Create(int width, int height, int depth, int channels){
+
+    Delete();
+
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_slots.resize(depth);
+
+    size_t frameBytes = (size_t) channels * width * height;
+    for (auto& slot : m_slots){
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, NULL, GL_STREAM_READ);
+        slot.fence = 0;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_oldest = 0;
+    m_pending = 0;
+    m_initialized = true;
+    return true;
+}
+
+void PixelReadback::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    for (auto& slot : m_slots){
+        if (slot.fence != 0)
+            glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pbo);
+    }
+    m_slots.clear();
+    m_oldest = 0;
+    m_pending = 0;
+    m_initialized = false;
+}
+
+void PixelReadback::Request(const std::string& filename){
+
+    if (Full()){
+        std::cout << "PixelReadback: ring is full, dropping " << filename << std::endl;
+        return;
+    }
+
+    Slot& slot = m_slots[(m_oldest + m_pending) % m_slots.size()];
+    slot.filename = filename;
+
+    // with a pack buffer bound glReadPixels returns immediately, the copy runs on the GPU
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, m_channels == 1 ? GL_RED : GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_pending++;
+}
+
+bool PixelReadback::CollectOldest(ReadbackFrame& frame, bool wait){
+
+    if (m_pending == 0)
+        return false;
+
+    Slot& slot = m_slots[m_oldest];
+
+    // poll (or block on) the fence guarding this slot
+    GLuint64 timeout = wait ? 1000000000ull : 0;
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    while (wait && status == GL_TIMEOUT_EXPIRED)
+        status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (status == GL_TIMEOUT_EXPIRED)
+        return false;
+
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+
+    size_t frameBytes = (size_t) m_channels * m_width * m_height;
+    frame.filename = slot.filename;
+    frame.pixels = m_pool.Acquire(frameBytes);
+    frame.width = m_width;
+    frame.height = m_height;
+    frame.channels = m_channels;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+    if (mapped != NULL){
+        std::memcpy(frame.pixels.data(), mapped, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+        std::cout << "PixelReadback: failed to map pixel buffer for " << slot.filename << std::endl;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_oldest = (m_oldest + 1) % m_slots.size();
+    m_pending--;
+    return mapped != NULL;
+}
@@ -0,0 +1,81 @@
+// OS_READBACK.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: asynchronous pixel readback through a ring of pixel pack
+//              buffers (PBO) plus a reusable pool of CPU frame buffers
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_READBACK_HPP
+#define OS_READBACK_HPP
+
+#include "include/glad/glad.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// recycles frame-sized byte buffers so steady-state capture does no heap allocation
+class BufferPool
+{
+public:
+    std::vector<unsigned char> Acquire(size_t bytes);
+    void Release(std::vector<unsigned char>&& buffer);
+
+private:
+    std::mutex m_mutex;
+    std::vector< std::vector<unsigned char> > m_free;
+};
+
+// a frame that has finished its transfer from the GPU
+struct ReadbackFrame
+{
+    std::string filename;
+    std::vector<unsigned char> pixels;
+    int width;
+    int height;
+    int channels;
+};
+
+class PixelReadback
+{
+public:
+    PixelReadback();
+
+    // depth = number of frames that may be in flight at once, channels = 3 (RGB) or 1 (red only)
+    bool Create(int width, int height, int depth, int channels = 3);
+    void Delete();
+
+    // start copying the current read buffer into the next free PBO (ring must not be full)
+    void Request(const std::string& filename);
+
+    // hand over the oldest in-flight frame; returns false if none is ready (or none pending)
+    bool CollectOldest(ReadbackFrame& frame, bool wait);
+
+    bool Full()    { return m_pending == (int) m_slots.size(); };
+    int Pending()  { return m_pending; };
+
+    int m_width;
+    int m_height;
+    int m_channels;
+    bool m_initialized;
+    BufferPool m_pool;
+
+private:
+    struct Slot
+    {
+        GLuint pbo;
+        GLsync fence;
+        std::string filename;
+    };
+
+    std::vector<Slot> m_slots;
+    int m_oldest;
+    int m_pending;
+};
+
+#endif
@@ -0,0 +1,175 @@
+// OS_RENDERSTATE.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GL state caching for the CAD draw path: cached uniform
+//              locations and values per program, redundant program and
+//              texture bind elimination, per-frame uniform block
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_renderstate.hpp"
+
+#include <cstring>
+
+// ------------------------------------------------------------------------
+// ProgramUniforms
+// ------------------------------------------------------------------------
+ProgramUniforms::ProgramUniforms() :
+    m_program(0),
+    m_frameBlock(GL_INVALID_INDEX)
+{
+}
+
+ProgramUniforms::Entry& ProgramUniforms::Lookup(const char* name){
+
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()){
+        Entry entry;
+        entry.location = glGetUniformLocation(m_program, name);
+        entry.size = 0;
+        it = m_entries.emplace(name, entry).first;
+    }
+    return it->second;
+}
+
+bool ProgramUniforms::Changed(Entry& entry, const float* value, int size){
+
+    // unknown names (location -1) are remembered too, and never sent
+    if (entry.location < 0)
+        return false;
+    if (entry.size == size && std::memcmp(entry.value, value, size*sizeof(float)) == 0)
+        return false;
+    entry.size = size;
+    std::memcpy(entry.value, value, size*sizeof(float));
+    return true;
+}
+
+void ProgramUniforms::SetMat4(const char* name, const float* m){
+    Entry& entry = Lookup(name);
+    if (Changed(entry, m, 16))
+        glUniformMatrix4fv(entry.location, 1, GL_FALSE, m);
+}
+
+void ProgramUniforms::SetVec3(const char* name, float x, float y, float z){
+    const float v[3] = {x, y, z};
+    Entry& entry = Lookup(name);
+    if (Changed(entry, v, 3))
+        glUniform3f(entry.location, x, y, z);
+}
+
+void ProgramUniforms::SetFloat(const char* name, float x){
+    Entry& entry = Lookup(name);
+    if (Changed(entry, &x, 1))
+        glUniform1f(entry.location, x);
+}
+
+void ProgramUniforms::SetInt(const char* name, int x){
+    // cached by bit pattern
+    float bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    Entry& entry = Lookup(name);
+    if (Changed(entry, &bits, 1))
+        glUniform1i(entry.location, x);
+}
+
+bool ProgramUniforms::Has(const char* name){
+    return Lookup(name).location >= 0;
+}
+
+// ------------------------------------------------------------------------
+// RenderState
+// ------------------------------------------------------------------------
+RenderState::RenderState() :
+    m_initialized(false),
+    m_frameUBO(0),
+    m_frameValid(false)
+{
+    Invalidate();
+}
+
+void RenderState::Create(){
+
+    Delete();
+
+    glGenBuffers(1, &m_frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, m_frameUBO);
+
+    m_frameValid = false;
+    m_initialized = true;
+}
+
+void RenderState::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteBuffers(1, &m_frameUBO);
+    m_frameUBO = 0;
+    m_programs.clear();
+    m_initialized = false;
+}
+
+void RenderState::Invalidate(){
+    m_program = UNKNOWN;
+    m_unit = UNKNOWN;
+    for (int i = 0; i < MAX_UNITS; i++)
+        m_textures[i] = UNKNOWN;
+}
+
+void RenderState::UseProgram(GLuint program){
+
+    if (program == m_program)
+        return;
+    glUseProgram(program);
+    m_program = program;
+}
+
+void RenderState::BindTexture2D(GLuint unit, GLuint texture){
+
+    int i = unit - GL_TEXTURE0;
+    bool tracked = i >= 0 && i < MAX_UNITS;
+    if (tracked && m_textures[i] == texture)
+        return;
+    if (unit != m_unit){
+        glActiveTexture(unit);
+        m_unit = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (tracked)
+        m_textures[i] = texture;
+}
+
+ProgramUniforms& RenderState::Uniforms(GLuint program){
+
+    auto it = m_programs.find(program);
+    if (it == m_programs.end()){
+        ProgramUniforms uniforms;
+        uniforms.m_program = program;
+        uniforms.m_frameBlock = glGetUniformBlockIndex(program, "Frame");
+        if (uniforms.m_frameBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, uniforms.m_frameBlock, FRAME_BINDING);
+        it = m_programs.emplace(program, uniforms).first;
+    }
+    return it->second;
+}
+
+void RenderState::UpdateFrameBlock(const FrameBlock& frame){
+
+    if (m_initialized == false)
+        Create();
+    if (m_frameValid && std::memcmp(&m_frame, &frame, sizeof(FrameBlock)) == 0)
+        return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_frame = frame;
+    m_frameValid = true;
+}
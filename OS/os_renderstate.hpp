@@ -0,0 +1,115 @@
+// OS_RENDERSTATE.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: GL state caching for the CAD draw path: cached uniform
+//              locations and values per program, redundant program and
+//              texture bind elimination, per-frame uniform block
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_RENDERSTATE_HPP
+#define OS_RENDERSTATE_HPP
+
+#include "include/glad/glad.h"
+
+#include <string>
+#include <unordered_map>
+
+// camera and light state shared by every CAD shader, std140 layout of
+//
+//   layout(std140) uniform Frame {
+//       mat4 view;
+//       vec4 r_Go2Vo_gl;                                    // xyz: camera position
+//       vec4 sun_r_Go2Lo_gl, sun_ambient, sun_diffuse, sun_specular;
+//       vec4 moon_r_Go2Lo_gl, moon_ambient, moon_diffuse, moon_specular;
+//   };
+//
+// shaders declaring the block get it on binding point FRAME_BINDING and are not sent the
+// equivalent plain uniforms; shaders without it keep receiving "view", "r_Go2Vo_gl", "sun.*", ...
+struct FrameBlock
+{
+    float view[16];
+    float r_Go2Vo_gl[4];
+    float sun[4][4];
+    float moon[4][4];
+};
+
+// uniforms of one program: locations looked up once, values sent only when they change
+class ProgramUniforms
+{
+public:
+    ProgramUniforms();
+
+    // the program must be current (RenderState::UseProgram) for the setters
+    void SetMat4(const char* name, const float* m);
+    void SetVec3(const char* name, float x, float y, float z);
+    void SetFloat(const char* name, float x);
+    void SetInt(const char* name, int x);
+
+    // the program declares (and uses) this uniform
+    bool Has(const char* name);
+
+    GLuint m_program;
+    GLuint m_frameBlock;            // GL_INVALID_INDEX if the program has no Frame block
+
+private:
+    struct Entry
+    {
+        GLint location;
+        int size;                   // floats in 'value', 0 until the first set
+        float value[16];
+    };
+
+    Entry& Lookup(const char* name);
+
+    // true if the value differs from what the program holds (and records it)
+    bool Changed(Entry& entry, const float* value, int size);
+
+    std::unordered_map<std::string, Entry> m_entries;
+};
+
+class RenderState
+{
+public:
+    static const GLuint FRAME_BINDING = 0;
+
+    RenderState();
+
+    void Create();
+    void Delete();
+
+    // forget the bindings, e.g. once per frame or after code outside this cache changed them
+    // (uniform values live in the programs and stay valid)
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindTexture2D(GLuint unit, GLuint texture);
+
+    // per-program cache, queries the Frame block on first use
+    ProgramUniforms& Uniforms(GLuint program);
+
+    // uploads the frame block if it differs from the last one
+    void UpdateFrameBlock(const FrameBlock& frame);
+
+    bool m_initialized;
+
+private:
+    static const int MAX_UNITS = 8;
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    GLuint m_frameUBO;
+    FrameBlock m_frame;
+    bool m_frameValid;
+
+    GLuint m_program;
+    GLuint m_unit;
+    GLuint m_textures[MAX_UNITS];
+
+    std::unordered_map<GLuint, ProgramUniforms> m_programs;
+};
+
+#endif
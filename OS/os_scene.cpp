@@ -0,0 +1,153 @@
+// OS_SCENE.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: scene description files for the stand-alone drivers
+//              (os_farm, os_benchmark): camera, bodies and their shaders,
+//              and pose table rows as S3 states
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_scene.hpp"
+#include "os_assetloader.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+static std::string Trim(const std::string& s){
+    size_t a = s.find_first_not_of(" \t\r"), b = s.find_last_not_of(" \t\r");
+    return a == std::string::npos ? std::string() : s.substr(a, b - a + 1);
+}
+
+void SceneConfig::Load(const std::string& path){
+
+    std::ifstream in(path.c_str());
+    if (!in)
+        throw std::runtime_error("SceneConfig: cannot open " + path + "\n");
+
+    m_values.clear();
+    std::string line;
+    while (std::getline(in, line)){
+        size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            continue;
+        m_values[Trim(line.substr(0, eq))] = Trim(line.substr(eq + 1));
+    }
+}
+
+bool SceneConfig::Has(const std::string& key) const{
+    return m_values.count(key) > 0;
+}
+
+double SceneConfig::Number(const std::string& key) const{
+    auto it = m_values.find(key);
+    if (it == m_values.end())
+        throw std::runtime_error("SceneConfig: missing " + key + "\n");
+    return atof(it->second.c_str());
+}
+
+std::string SceneConfig::String(const std::string& key, const std::string& fallback) const{
+    auto it = m_values.find(key);
+    return it == m_values.end() ? fallback : it->second;
+}
+
+void SceneConfig::LoadBodies(GL& gl) const{
+
+    const char* names[] = {"tango", "triad", "earth", "star"};
+    CAD* bodies[] = {&gl.m_tango, &gl.m_triad, &gl.m_earth, &gl.m_star};
+    const int N_BODIES = 4;
+
+    AssetLoader loader(gl);
+    std::vector<int> slot(N_BODIES, -1);
+    for (int b = 0; b < N_BODIES; b++){
+        std::string name = names[b];
+        if (!Has(name + ".csv") && !Has(name + ".procedural"))
+            continue;
+        std::string root = String(name + ".root", "");
+        std::string csv = String(name + ".csv", "");
+        std::string diffuse = String(name + ".diffuse", "");
+        std::string specular = String(name + ".specular", "");
+        float scale = (float) atof(String(name + ".scale", "1").c_str());
+        if (Has(name + ".procedural"))
+            slot[b] = loader.AddProceduralSphere(atoi(String(name + ".procedural", "0").c_str()),
+                                                 (float) Number(name + ".radius"), diffuse, specular, scale);
+        else if (atoi(String(name + ".sphere", "0").c_str()) != 0)
+            slot[b] = loader.AddTexturedSphere(root, csv, diffuse, specular, scale);
+        else
+            slot[b] = loader.AddCAD(root, csv, diffuse, specular, scale);
+    }
+
+    std::vector<CAD> cads = loader.Load(0);
+    for (int b = 0; b < N_BODIES; b++){
+        if (slot[b] < 0)
+            continue;
+        std::string name = names[b];
+        *bodies[b] = cads[slot[b]];
+        if (!gl.m_software)
+            bodies[b]->shader = Shader(String(name + ".vs", "").c_str(), String(name + ".fs", "").c_str());
+        bodies[b]->on = true;
+    }
+
+    // the sun has no geometry, it only lights the bodies from the direction of each state
+    if (atoi(String("sun.on", "0").c_str()) != 0)
+        gl.m_sun.initialized = true;
+}
+
+void SceneConfig::ApplyStarPSF(GL& gl) const{
+
+    StarPhotometry photometry;
+    if (Has("psf.zeroPointFlux"))
+        photometry.zeroPointFlux = Number("psf.zeroPointFlux");
+    if (Has("psf.aperture"))
+        photometry.aperture = Number("psf.aperture");
+    if (Has("psf.exposure"))
+        photometry.exposure = Number("psf.exposure");
+    if (Has("psf.efficiency"))
+        photometry.efficiency = Number("psf.efficiency");
+    if (Has("psf.fullWell"))
+        photometry.fullWell = Number("psf.fullWell");
+    gl.SetStarPSF(photometry, (float) atof(String("psf.sigma", "0.7").c_str()));
+}
+
+void SceneConfig::ApplySensor(GL& gl) const{
+
+    SensorSettings sensor;
+    sensor.on = atoi(String("sensor.on", "0").c_str()) != 0;
+    sensor.blurSigma = (float) atof(String("sensor.blur", "0").c_str());
+    sensor.vignetting = (float) atof(String("sensor.vignetting", "0").c_str());
+    sensor.fullWell = (float) atof(String("sensor.fullWell", String("psf.fullWell", "1e4")).c_str());
+    sensor.readNoise = (float) atof(String("sensor.readNoise", "10").c_str());
+    sensor.darkCurrent = (float) atof(String("sensor.darkCurrent", "0").c_str());
+    sensor.exposure = (float) atof(String("sensor.exposure", String("psf.exposure", "0.2")).c_str());
+    sensor.bits = atoi(String("sensor.bits", "8").c_str());
+    sensor.seed = (unsigned int) strtoul(String("sensor.seed", "0").c_str(), NULL, 10);
+    gl.SetSensor(sensor);
+}
+
+S3 PoseState(const PoseTable& poses, int row){
+
+    const double* p = poses.Row(row);
+    S3 s3;
+    s3.r_Vo2To_vbs = Vector(p[0], p[1], p[2]);
+    s3.q_vbs2tango = Vector(p[3], p[4], p[5], p[6]);
+    s3.r_Vo2So_vbs = Vector(p[7], p[8], p[9]);
+    if (poses.HasFull()){
+        s3.q_eci2vbs = Vector(p[10], p[11], p[12], p[13]);
+        s3.r_Vo2Eo_vbs = Vector(p[14], p[15], p[16]);
+        s3.q_vbs2ecef = Vector(p[17], p[18], p[19], p[20]);
+    }
+    else {
+        s3.q_eci2vbs = Vector(1.0, 0.0, 0.0, 0.0);
+        s3.r_Vo2Eo_vbs = Vector(0.0, 0.0, -1.0e9);
+        s3.q_vbs2ecef = Vector(1.0, 0.0, 0.0, 0.0);
+    }
+    return s3;
+}
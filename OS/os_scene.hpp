@@ -0,0 +1,66 @@
+// OS_SCENE.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: scene description files for the stand-alone drivers
+//              (os_farm, os_benchmark): camera, bodies and their shaders,
+//              and pose table rows as S3 states
+//
+//   "key = value" per line, '#' comments:
+//     Nu Nv ppx ppy fx fy magThresh halfFOV        camera (as OpticalStimulator)
+//     <body>.csv <body>.root <body>.diffuse <body>.specular <body>.scale
+//     <body>.vs <body>.fs <body>.sphere (0/1)      body = tango, triad, earth, star
+//     <body>.procedural <body>.radius              generated sphere (subdivision level, radius
+//                                                  [m]) instead of <body>.csv
+//     sun.on (0/1)                                 sun light along each state's r_Vo2So_vbs
+//     psf.sigma psf.zeroPointFlux psf.aperture     star PSF and photometry (optional,
+//     psf.exposure psf.efficiency psf.fullWell     see StarPhotometry)
+//     sensor.on (0/1) sensor.blur sensor.vignetting sensor model before readback (optional,
+//     sensor.fullWell sensor.readNoise             see SensorSettings; fullWell and exposure
+//     sensor.darkCurrent sensor.exposure           default to the psf.* values)
+//     sensor.bits sensor.seed
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SCENE_HPP
+#define OS_SCENE_HPP
+
+#include "os_gl.hpp"
+#include "os_opticalstimulator.hpp"
+#include "os_posetable.hpp"
+#include "os_starpsf.hpp"
+
+#include <map>
+#include <string>
+
+class SceneConfig
+{
+public:
+    // throws std::runtime_error if the file cannot be read
+    void Load(const std::string& path);
+
+    bool Has(const std::string& key) const;
+    double Number(const std::string& key) const;        // throws if missing
+    std::string String(const std::string& key, const std::string& fallback) const;
+
+    // every body present in the file, in one AssetLoader pass (parsing and texture decoding
+    // run in parallel); bodies come out switched on with their shader
+    void LoadBodies(GL& gl) const;
+
+    // psf.* keys over the StarPhotometry defaults; sigma in pixels
+    void ApplyStarPSF(GL& gl) const;
+
+    // sensor.* keys over the SensorSettings defaults
+    void ApplySensor(GL& gl) const;
+
+    std::map<std::string, std::string> m_values;
+};
+
+// pose table row as render state; 10-column tables get identity star/Earth attitudes
+// and the Earth far behind the camera
+S3 PoseState(const PoseTable& poses, int row);
+
+#endif
@@ -0,0 +1,211 @@
+// OS_SHADOWMAP.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: directional (sun) shadow map of one body, rendered in the
+//              body's own frame and reused while the sun direction in
+//              that frame does not change
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_shadowmap.hpp"
+#include "os_glprogram.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+// position only (location 0 of every CAD vertex format), depth is all the pass writes
+static const char* SHADOW_VS = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 lightClip;
+void main()
+{
+    gl_Position = lightClip * vec4(aPos, 1.0);
+}
+)";
+
+static const char* SHADOW_FS = R"(
+#version 330 core
+void main()
+{
+}
+)";
+
+// 1e-6 of the map extent is far below a texel for any map size GL allows
+const double ShadowMap::TOLERANCE = 1.0e-6;
+
+ShadowMap::ShadowMap() :
+    m_size(0),
+    m_depth(0),
+    m_initialized(false),
+    m_fbo(0),
+    m_program(0),
+    m_locMatrix(-1),
+    m_valid(false),
+    m_keyVBO(0),
+    m_keyElements(0)
+{
+    for (int i = 0; i < 16; i++)
+        m_matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    m_keySun[0] = m_keySun[1] = m_keySun[2] = 0.0;
+}
+
+bool ShadowMap::Create(int size){
+
+    // release any previous allocation
+    Delete();
+
+    m_program = CompileProgram(SHADOW_VS, SHADOW_FS, "shadowmap");
+    if (m_program == 0)
+        return false;
+    m_locMatrix = glGetUniformLocation(m_program, "lightClip");
+
+    // outside the map (border depth 1) compares as lit
+    const float WHITE[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glGenTextures(1, &m_depth);
+    glBindTexture(GL_TEXTURE_2D, m_depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, WHITE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint drawFbo;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depth, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, drawFbo);
+
+    m_size = size;
+    m_valid = false;
+    m_initialized = true;
+    if (!complete){
+        std::cout << "Shadow map framebuffer is incomplete (" << size << "x" << size << ")" << std::endl;
+        Delete();
+        return false;
+    }
+    return true;
+}
+
+void ShadowMap::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteFramebuffers(1, &m_fbo);
+    glDeleteTextures(1, &m_depth);
+    glDeleteProgram(m_program);
+    m_fbo = 0;
+    m_depth = 0;
+    m_program = 0;
+    m_size = 0;
+    m_valid = false;
+    m_initialized = false;
+}
+
+bool ShadowMap::Current(const Mesh& mesh, const double sun[3]) const{
+
+    if (!m_valid || m_keyVBO != mesh.m_VBO || m_keyElements != mesh.ElementCount())
+        return false;
+    double dx = sun[0] - m_keySun[0], dy = sun[1] - m_keySun[1], dz = sun[2] - m_keySun[2];
+    return dx*dx + dy*dy + dz*dz < TOLERANCE * TOLERANCE;
+}
+
+void ShadowMap::Render(Mesh& mesh, const double sun[3]){
+
+    if (m_initialized == false || mesh.m_initialized == false)
+        return;
+
+    // light basis in the model frame: w towards the sun, u and v across the beam
+    double w[3] = {sun[0], sun[1], sun[2]};
+    double a[3] = {0.0, 0.0, 0.0};
+    a[std::fabs(w[0]) < 0.9 ? 0 : 1] = 1.0;
+    double u[3] = {a[1]*w[2] - a[2]*w[1], a[2]*w[0] - a[0]*w[2], a[0]*w[1] - a[1]*w[0]};
+    double n = std::sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]);
+    for (int c = 0; c < 3; c++)
+        u[c] /= n;
+    double v[3] = {w[1]*u[2] - w[2]*u[1], w[2]*u[0] - w[0]*u[2], w[0]*u[1] - w[1]*u[0]};
+
+    // extent of the part boxes along the basis
+    double lo[3] = {DBL_MAX, DBL_MAX, DBL_MAX}, hi[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+    const double* axes[3] = {u, v, w};
+    for (size_t k = 0; k < mesh.m_count.size(); k++){
+        if (mesh.m_count[k] == 0 || mesh.m_bounds.size() < 6*(k + 1))
+            continue;
+        const float* b = &mesh.m_bounds[6*k];
+        for (int corner = 0; corner < 8; corner++){
+            double p[3] = {b[corner & 1 ? 3 : 0], b[corner & 2 ? 4 : 1], b[corner & 4 ? 5 : 2]};
+            for (int i = 0; i < 3; i++){
+                double d = axes[i][0]*p[0] + axes[i][1]*p[1] + axes[i][2]*p[2];
+                lo[i] = std::min(lo[i], d);
+                hi[i] = std::max(hi[i], d);
+            }
+        }
+    }
+    if (lo[0] > hi[0])
+        return;
+
+    // texture coordinates over the box grown by a texel, depth 0 nearest the sun
+    double scale[3], offset[3];
+    for (int i = 0; i < 2; i++){
+        double margin = (hi[i] - lo[i]) / m_size + 1e-6;
+        scale[i] = 1.0 / (hi[i] - lo[i] + 2*margin);
+        offset[i] = -(lo[i] - margin) * scale[i];
+    }
+    double depth = hi[2] - lo[2] + 1e-6;
+    scale[2] = -1.0 / depth;
+    offset[2] = hi[2] / depth;
+
+    float clip[16];
+    for (int i = 0; i < 3; i++){
+        for (int c = 0; c < 3; c++){
+            m_matrix[4*c + i] = (float) (scale[i] * axes[i][c]);
+            clip[4*c + i] = 2.0f * m_matrix[4*c + i];
+        }
+        m_matrix[12 + i] = (float) offset[i];
+        clip[12 + i] = (float) (2.0 * offset[i] - 1.0);
+    }
+    for (int c = 0; c < 3; c++)
+        m_matrix[4*c + 3] = clip[4*c + 3] = 0.0f;
+    m_matrix[15] = clip[15] = 1.0f;
+
+    GLint drawFbo, viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // slope-scaled offset keeps lit faces from shadowing themselves
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_size, m_size);
+    const float FAR_PLANE = 1.0f;
+    glClearBufferfv(GL_DEPTH, 0, &FAR_PLANE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+    glUseProgram(m_program);
+    glUniformMatrix4fv(m_locMatrix, 1, GL_FALSE, clip);
+    mesh.Draw();
+    glBindVertexArray(0);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    m_valid = true;
+    m_keyVBO = mesh.m_VBO;
+    m_keyElements = mesh.ElementCount();
+    for (int c = 0; c < 3; c++)
+        m_keySun[c] = sun[c];
+}
@@ -0,0 +1,74 @@
+// OS_SHADOWMAP.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: directional (sun) shadow map of one body, rendered in the
+//              body's own frame and reused while the sun direction in
+//              that frame does not change
+//
+//   CAD shaders opt in by declaring (GL::DrawCAD sets them, shaders
+//   without them render unshadowed as before):
+//
+//     uniform sampler2DShadow sunShadow;       // texture unit ShadowMap::UNIT
+//     uniform mat4 sunShadowMatrix;            // GL world -> map (xy texture, z depth)
+//     uniform int sunShadowOn;                 // 0: no map for this draw (sun off, lamp on)
+//
+//     float lit = (sunShadowOn != 0) ? texture(sunShadow, (sunShadowMatrix * vec4(FragPos, 1.0)).xyz) : 1.0;
+//     // sun diffuse and specular terms times lit, ambient unchanged
+//
+//   Existing CAD shaders must be extended to get shadows; GL::SunShadow names
+//   every program drawn under the sun without them (once), and counts shadowed
+//   draws in GL::m_shadowedDraws. bench/body.fs is a complete example.
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SHADOWMAP_HPP
+#define OS_SHADOWMAP_HPP
+
+#include "include/glad/glad.h"
+#include "os_mesh.hpp"
+
+class ShadowMap
+{
+public:
+    static const int UNIT = 2;              // after the diffuse (0) and specular (1) maps
+
+    ShadowMap();
+
+    // size x size depth texture with hardware comparison (2x2 filtered lookups)
+    bool Create(int size);
+    void Delete();
+
+    // true if the map already holds mesh lit from sun (unit vector towards the sun, model
+    // frame): the same vertex buffer and a direction within TOLERANCE of the rendered one
+    bool Current(const Mesh& mesh, const double sun[3]) const;
+
+    // depth of every part of mesh seen from the sun, orthographic over the mesh bounds;
+    // restores the bound framebuffer and viewport, leaves its program bound
+    void Render(Mesh& mesh, const double sun[3]);
+
+    // model position -> map texture coordinates and compared depth (column major)
+    float m_matrix[16];
+
+    int m_size;
+    GLuint m_depth;
+    bool m_initialized;
+
+private:
+    static const double TOLERANCE;
+
+    GLuint m_fbo;
+    GLuint m_program;
+    GLint m_locMatrix;
+
+    // what the map was rendered from
+    bool m_valid;
+    GLuint m_keyVBO;
+    int m_keyElements;
+    double m_keySun[3];
+};
+
+#endif
@@ -0,0 +1,302 @@
+// OS_SHARDWRITER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: training-ready output: raw tensors (frames, masks, depth)
+//              streamed into sharded TFRecord files with a fixed-size
+//              binary index for memory-mapped random access
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_shardwriter.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE4_2__)
+    #include <nmmintrin.h>
+#endif
+
+// ------------------------------------------------------------------------
+// CRC-32C
+// ------------------------------------------------------------------------
+#if !defined(__SSE4_2__)
+static const uint32_t* Crc32cTable(){
+    static uint32_t table[256];
+    static bool built = false;
+    if (!built){
+        for (uint32_t i = 0; i < 256; i++){
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : (c >> 1);
+            table[i] = c;
+        }
+        built = true;
+    }
+    return table;
+}
+#endif
+
+uint32_t Crc32c(uint32_t crc, const void* data, size_t size){
+
+    const unsigned char* p = (const unsigned char*) data;
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t c = crc;
+    for (; size >= 8; size -= 8, p += 8){
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    crc = (uint32_t) c;
+    for (; size > 0; size--, p++)
+        crc = _mm_crc32_u8(crc, *p);
+#else
+    const uint32_t* table = Crc32cTable();
+    for (; size > 0; size--, p++)
+        crc = table[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+#endif
+    return ~crc;
+}
+
+static uint32_t MaskedCrc(uint32_t crc){
+    return ((crc >> 15) | (crc << 17)) + 0xA282EAD8u;
+}
+
+// ------------------------------------------------------------------------
+// protobuf wire format, just enough for tf.train.Example
+// ------------------------------------------------------------------------
+static void Varint(std::string& out, uint64_t value){
+    while (value >= 0x80){
+        out += (char) (value | 0x80);
+        value >>= 7;
+    }
+    out += (char) value;
+}
+
+// field 'field' with wire type 2 (length delimited)
+static void Delimited(std::string& out, int field, const std::string& body){
+    out += (char) ((field << 3) | 2);
+    Varint(out, body.size());
+    out += body;
+}
+
+// Features.feature map entry {key = 1, value = 2 (Feature)}
+static std::string Entry(const std::string& key, const std::string& feature){
+    std::string entry, framed;
+    Delimited(entry, 1, key);
+    Delimited(entry, 2, feature);
+    Delimited(framed, 1, entry);
+    return framed;
+}
+
+// Feature.int64_list = 3, Int64List.value = 1 (packed)
+static std::string Int64Feature(const std::vector<int64_t>& values){
+    std::string packed, list, feature;
+    for (int64_t v : values)
+        Varint(packed, (uint64_t) v);
+    Delimited(list, 1, packed);
+    Delimited(feature, 3, list);
+    return feature;
+}
+
+// Feature.bytes_list = 1, BytesList.value = 1
+static std::string BytesFeature(const std::string& value){
+    std::string list, feature;
+    Delimited(list, 1, value);
+    Delimited(feature, 1, list);
+    return feature;
+}
+
+// ------------------------------------------------------------------------
+// TensorSpec
+// ------------------------------------------------------------------------
+size_t TensorSpec::Bytes() const{
+    size_t n = (type == TENSOR_UINT8) ? 1 : (type == TENSOR_UINT16) ? 2 : 4;
+    for (int64_t d : shape)
+        n *= (size_t) d;
+    return n;
+}
+
+const char* TensorSpec::TypeName() const{
+    return (type == TENSOR_UINT8) ? "uint8" : (type == TENSOR_UINT16) ? "uint16" : "float32";
+}
+
+// ------------------------------------------------------------------------
+// ShardWriter
+// ------------------------------------------------------------------------
+ShardWriter::ShardWriter() :
+    m_recordsPerShard(0),
+    m_shard(0),
+    m_records(0),
+    m_written(0),
+    m_offset(0),
+    m_data(NULL),
+    m_index(NULL)
+{
+}
+
+ShardWriter::~ShardWriter(){
+    Close();
+}
+
+bool ShardWriter::Open(const std::string& prefix, const std::vector<TensorSpec>& tensors, int recordsPerShard){
+
+    Close();
+    m_prefix = prefix;
+    m_tensors = tensors;
+    m_recordsPerShard = recordsPerShard;
+    m_shard = 0;
+    m_written = 0;
+
+    // every tensor has a fixed size, so all framing but the row number is known up front:
+    // m_prefixes[i] = map entry of tensor i up to its raw bytes, shape/dtype entries after the
+    // last tensor
+    m_prefixes.clear();
+    std::string meta;
+    for (const auto& t : m_tensors){
+        size_t bytes = t.Bytes();
+
+        // BytesList {value: raw} inside Feature {bytes_list} inside the map entry, built without the payload
+        std::string list, feature, entry, framed;
+        list += (char) ((1 << 3) | 2);
+        Varint(list, bytes);
+        feature += (char) ((1 << 3) | 2);
+        Varint(feature, list.size() + bytes);
+        feature += list;
+        Delimited(entry, 1, t.name);
+        entry += (char) ((2 << 3) | 2);
+        Varint(entry, feature.size() + bytes);
+        entry += feature;
+        framed += (char) ((1 << 3) | 2);
+        Varint(framed, entry.size() + bytes);
+        framed += entry;
+        m_prefixes.push_back(framed);
+
+        meta += Entry(t.name + "/shape", Int64Feature(t.shape));
+        meta += Entry(t.name + "/dtype", BytesFeature(t.TypeName()));
+    }
+    m_prefixes.push_back(meta);
+
+    return OpenShard();
+}
+
+bool ShardWriter::OpenShard(){
+
+    if (m_data != NULL)
+        fclose(m_data);
+    if (m_index != NULL)
+        fclose(m_index);
+    m_data = NULL;
+    m_index = NULL;
+
+    std::string name = ShardName(m_shard);
+    m_shardPath = name + ".tfrecord";
+    m_data = fopen(m_shardPath.c_str(), "wb");
+    m_index = fopen((name + ".index").c_str(), "wb");
+    m_records = 0;
+    m_offset = 0;
+    if (m_data == NULL || m_index == NULL){
+        std::cout << "ShardWriter: cannot create " << m_shardPath << std::endl;
+        Close();
+        return false;
+    }
+
+    uint32_t header[2] = {INDEX_VERSION, (uint32_t) m_tensors.size()};
+    fwrite("OSRI", 1, 4, m_index);
+    fwrite(header, sizeof(uint32_t), 2, m_index);
+    for (const auto& t : m_tensors){
+        uint32_t desc[3] = {(uint32_t) t.name.size(), 0, 0};
+        fwrite(&desc[0], sizeof(uint32_t), 1, m_index);
+        fwrite(t.name.data(), 1, t.name.size(), m_index);
+        desc[1] = (uint32_t) t.type;
+        desc[2] = (uint32_t) t.shape.size();
+        fwrite(&desc[1], sizeof(uint32_t), 2, m_index);
+        fwrite(t.shape.data(), sizeof(int64_t), t.shape.size(), m_index);
+    }
+    return ferror(m_index) == 0;
+}
+
+bool ShardWriter::Write(int64_t row, const std::vector<const void*>& data){
+
+    if (m_data == NULL || data.size() != m_tensors.size())
+        return false;
+    if (m_recordsPerShard > 0 && m_records == m_recordsPerShard){
+        m_shard++;
+        if (!OpenShard())
+            return false;
+    }
+
+    // "row" entry, the only part that changes length between records
+    std::string rowEntry = Entry("row", Int64Feature(std::vector<int64_t>(1, row)));
+
+    uint64_t featuresBytes = m_prefixes.back().size() + rowEntry.size();
+    for (size_t i = 0; i < m_tensors.size(); i++)
+        featuresBytes += m_prefixes[i].size() + m_tensors[i].Bytes();
+    std::string head;
+    head += (char) ((1 << 3) | 2);
+    Varint(head, featuresBytes);
+    uint64_t length = head.size() + featuresBytes;
+
+    // TFRecord framing: length, masked crc of length, data, masked crc of data
+    uint32_t lengthCrc = MaskedCrc(Crc32c(0, &length, sizeof(length)));
+    fwrite(&length, sizeof(length), 1, m_data);
+    fwrite(&lengthCrc, sizeof(lengthCrc), 1, m_data);
+
+    std::vector<uint64_t> entry(3 + m_tensors.size());
+    entry[0] = (uint64_t) row;
+    entry[1] = m_offset;
+    entry[2] = length;
+
+    uint64_t position = m_offset + sizeof(length) + sizeof(lengthCrc);
+    uint32_t crc = Crc32c(0, head.data(), head.size());
+    fwrite(head.data(), 1, head.size(), m_data);
+    position += head.size();
+    for (size_t i = 0; i < m_tensors.size(); i++){
+        size_t bytes = m_tensors[i].Bytes();
+        const std::string& prefix = m_prefixes[i];
+        crc = Crc32c(crc, prefix.data(), prefix.size());
+        crc = Crc32c(crc, data[i], bytes);
+        fwrite(prefix.data(), 1, prefix.size(), m_data);
+        entry[3 + i] = position + prefix.size();
+        fwrite(data[i], 1, bytes, m_data);
+        position += prefix.size() + bytes;
+    }
+    crc = Crc32c(crc, m_prefixes.back().data(), m_prefixes.back().size());
+    crc = Crc32c(crc, rowEntry.data(), rowEntry.size());
+    fwrite(m_prefixes.back().data(), 1, m_prefixes.back().size(), m_data);
+    fwrite(rowEntry.data(), 1, rowEntry.size(), m_data);
+    uint32_t dataCrc = MaskedCrc(crc);
+    fwrite(&dataCrc, sizeof(dataCrc), 1, m_data);
+
+    fwrite(entry.data(), sizeof(uint64_t), entry.size(), m_index);
+
+    m_offset += sizeof(length) + sizeof(lengthCrc) + length + sizeof(dataCrc);
+    m_records++;
+    m_written++;
+    return ferror(m_data) == 0 && ferror(m_index) == 0;
+}
+
+std::string ShardWriter::ShardName(int shard) const{
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%05d", shard);
+    return m_prefix + suffix;
+}
+
+std::string ShardWriter::Location(int64_t n) const{
+    int64_t shard = (m_recordsPerShard > 0) ? n / m_recordsPerShard : 0;
+    int64_t record = (m_recordsPerShard > 0) ? n % m_recordsPerShard : n;
+    return ShardName((int) shard) + ".tfrecord#" + std::to_string(record);
+}
+
+void ShardWriter::Close(){
+    if (m_data != NULL)
+        fclose(m_data);
+    if (m_index != NULL)
+        fclose(m_index);
+    m_data = NULL;
+    m_index = NULL;
+}
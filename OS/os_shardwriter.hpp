@@ -0,0 +1,100 @@
+// OS_SHARDWRITER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: training-ready output: raw tensors (frames, masks, depth)
+//              streamed into sharded TFRecord files with a fixed-size
+//              binary index for memory-mapped random access
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SHARDWRITER_HPP
+#define OS_SHARDWRITER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum TensorType
+{
+    TENSOR_UINT8 = 1,
+    TENSOR_UINT16 = 2,
+    TENSOR_FLOAT32 = 3
+};
+
+struct TensorSpec
+{
+    std::string name;
+    TensorType type;
+    std::vector<int64_t> shape;             // e.g. {height, width, 3}, rows as read back from GL
+
+    size_t Bytes() const;
+    const char* TypeName() const;           // "uint8", "uint16", "float32"
+};
+
+// every record is a tf.train.Example (uncompressed TFRecord framing) with features
+//   "row"           int64       pose table row
+//   "<name>"        bytes       raw tensor, little-endian, C order
+//   "<name>/shape"  int64 list
+//   "<name>/dtype"  bytes       TypeName()
+// for each tensor of the schema given to Open.
+//
+// <shard>.index, all little-endian:
+//   "OSRI", uint32 version, uint32 nTensors,
+//   per tensor: uint32 nameLength, name, uint32 type, uint32 rank, int64 shape[rank]
+//   then one entry per record: uint64 row, uint64 recordOffset, uint64 recordLength,
+//                              uint64 dataOffset[nTensors]  (raw bytes in the .tfrecord)
+class ShardWriter
+{
+public:
+    static const uint32_t INDEX_VERSION = 1;
+
+    ShardWriter();
+    ~ShardWriter();
+
+    // shards are <prefix>-00000.tfrecord, <prefix>-00001.tfrecord, ..., a new one every
+    // recordsPerShard records (<= 0: a single shard); false if the first shard cannot be created
+    bool Open(const std::string& prefix, const std::vector<TensorSpec>& tensors, int recordsPerShard);
+
+    // data[i] holds tensors[i].Bytes() bytes; false on an I/O error
+    bool Write(int64_t row, const std::vector<const void*>& data);
+    void Close();
+
+    // where the last Write went, for manifests
+    const std::string& ShardPath() const    { return m_shardPath; };
+    int RecordInShard() const               { return m_records - 1; };
+
+    // records written since Open, and "<shard path>#<record>" of the n-th of them (0-based)
+    int64_t Written() const                 { return m_written; };
+    std::string Location(int64_t n) const;
+
+    const std::vector<TensorSpec>& Tensors() const  { return m_tensors; };
+
+private:
+    bool OpenShard();
+    std::string ShardName(int shard) const;
+
+    std::string m_prefix;
+    std::vector<TensorSpec> m_tensors;
+    int m_recordsPerShard;
+
+    int m_shard;
+    int m_records;                          // in the current shard
+    int64_t m_written;                      // in all shards
+    uint64_t m_offset;                      // bytes written to the current shard
+    std::string m_shardPath;
+    FILE* m_data;
+    FILE* m_index;
+
+    // per-schema protobuf framing, built once by Open
+    std::vector<std::string> m_prefixes;    // bytes preceding each raw tensor
+};
+
+// CRC-32C (Castagnoli) as used by TFRecord, SSE4.2 when available
+uint32_t Crc32c(uint32_t crc, const void* data, size_t size);
+
+#endif
@@ -0,0 +1,165 @@
+// OS_SKYINDEX.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: sky-partitioned star catalog for fast cone queries
+//              stars are binned on a cube-face grid (6 x G x G cells)
+//              and stored SoA, sorted by cell
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_skyindex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// face f: major axis a = f/2, sign = (f%2 == 0) ? +1 : -1
+static void FaceToVector(int face, double s, double t, double* v){
+    int axis = face / 2;
+    double sign = (face % 2 == 0) ? 1.0 : -1.0;
+    double p[3];
+    p[axis] = sign;
+    p[(axis + 1) % 3] = s;
+    p[(axis + 2) % 3] = t;
+    double norm = std::sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+    v[0] = p[0] / norm;
+    v[1] = p[1] / norm;
+    v[2] = p[2] / norm;
+}
+
+SkyIndex::SkyIndex() :
+    m_G(1)
+{
+}
+
+int SkyIndex::Cell(double x, double y, double z) const{
+
+    double p[3] = {x, y, z};
+    double ax = std::fabs(x), ay = std::fabs(y), az = std::fabs(z);
+    int axis = (ax >= ay && ax >= az) ? 0 : (ay >= az ? 1 : 2);
+    int face = 2*axis + (p[axis] >= 0 ? 0 : 1);
+
+    // gnomonic coordinates on the face, in [-1, 1]
+    double major = std::fabs(p[axis]);
+    double s = p[(axis + 1) % 3] / major;
+    double t = p[(axis + 2) % 3] / major;
+    int i = std::min(m_G - 1, std::max(0, (int) ((s + 1.0) * 0.5 * m_G)));
+    int j = std::min(m_G - 1, std::max(0, (int) ((t + 1.0) * 0.5 * m_G)));
+    return (face * m_G + i) * m_G + j;
+}
+
+void SkyIndex::Build(const double* x, const double* y, const double* z, const double* mag, int N, double halfFOV){
+
+    // cells about halfFOV / 2 wide, so about four across a query cone (a face spans 90 deg)
+    m_G = (int) std::ceil(M_PI / halfFOV);
+    m_G = std::max(1, std::min(64, m_G));
+    int nCells = 6 * m_G * m_G;
+
+    // cell geometry: center direction and the largest angle to any of its corners
+    m_cellCenter.resize(3 * nCells);
+    m_cellCosRadius.resize(nCells);
+    m_cellSinRadius.resize(nCells);
+    double h = 2.0 / m_G;
+    for (int face = 0; face < 6; face++){
+        for (int i = 0; i < m_G; i++){
+            for (int j = 0; j < m_G; j++){
+                int c = (face * m_G + i) * m_G + j;
+                double s0 = -1.0 + i*h, t0 = -1.0 + j*h;
+                double* center = &m_cellCenter[3*c];
+                FaceToVector(face, s0 + 0.5*h, t0 + 0.5*h, center);
+                double minDot = 1.0;
+                for (int k = 0; k < 4; k++){
+                    double corner[3];
+                    FaceToVector(face, s0 + (k & 1)*h, t0 + (k >> 1)*h, corner);
+                    double d = center[0]*corner[0] + center[1]*corner[1] + center[2]*corner[2];
+                    minDot = std::min(minDot, d);
+                }
+                double radius = std::acos(std::max(-1.0, std::min(1.0, minDot)));
+                m_cellCosRadius[c] = std::cos(radius);
+                m_cellSinRadius[c] = std::sin(radius);
+            }
+        }
+    }
+
+    // 8-neighbourhood: one cell step on the face plane, past its edge onto the adjacent face
+    m_cellNeighbors.resize(8 * nCells);
+    for (int face = 0; face < 6; face++){
+        for (int i = 0; i < m_G; i++){
+            for (int j = 0; j < m_G; j++){
+                int c = (face * m_G + i) * m_G + j, k = 0;
+                for (int di = -1; di <= 1; di++)
+                    for (int dj = -1; dj <= 1; dj++){
+                        if (di == 0 && dj == 0)
+                            continue;
+                        double v[3];
+                        FaceToVector(face, -1.0 + (i + 0.5 + di)*h, -1.0 + (j + 0.5 + dj)*h, v);
+                        m_cellNeighbors[8*c + k++] = Cell(v[0], v[1], v[2]);
+                    }
+            }
+        }
+    }
+
+    // counting sort of the catalog by cell
+    std::vector<int> cell(N);
+    m_cellStart.assign(nCells + 1, 0);
+    for (int k = 0; k < N; k++){
+        cell[k] = Cell(x[k], y[k], z[k]);
+        m_cellStart[cell[k] + 1]++;
+    }
+    for (int c = 0; c < nCells; c++)
+        m_cellStart[c + 1] += m_cellStart[c];
+
+    m_x.resize(N);
+    m_y.resize(N);
+    m_z.resize(N);
+    m_mag.resize(N);
+    std::vector<int> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (int k = 0; k < N; k++){
+        int dst = fill[cell[k]]++;
+        m_x[dst] = x[k];
+        m_y[dst] = y[k];
+        m_z[dst] = z[k];
+        m_mag[dst] = mag[k];
+    }
+}
+
+void SkyIndex::Query(const double* n, double halfFOV, std::vector<int>& out) const{
+
+    out.clear();
+    if (m_cellStart.empty())
+        return;
+
+    double cosFOV = std::cos(halfFOV);
+    double sinFOV = std::sin(halfFOV);
+
+    // the cells overlapping the cone are connected: flood from the boresight's cell, expanding
+    // only through cells that pass the cap test (a few dozen cells, a linear visited list is enough)
+    std::vector<int> visited(1, Cell(n[0], n[1], n[2]));
+    visited.reserve(64);
+    for (size_t q = 0; q < visited.size(); q++){
+        int c = visited[q];
+
+        // skip cells whose bounding cap cannot touch the cone: angle(n, center) > halfFOV + radius
+        const double* center = &m_cellCenter[3*c];
+        double d = center[0]*n[0] + center[1]*n[1] + center[2]*n[2];
+        double cosReach = cosFOV*m_cellCosRadius[c] - sinFOV*m_cellSinRadius[c];
+        bool reachBelowPi = cosFOV*m_cellSinRadius[c] + sinFOV*m_cellCosRadius[c] > 0;
+        if (reachBelowPi && d < cosReach)
+            continue;
+
+        for (int k = 0; k < 8; k++){
+            int neighbor = m_cellNeighbors[8*c + k];
+            if (std::find(visited.begin(), visited.end(), neighbor) == visited.end())
+                visited.push_back(neighbor);
+        }
+
+        // contiguous SoA scan of the candidate cell
+        for (int k = m_cellStart[c]; k < m_cellStart[c + 1]; k++){
+            if (m_x[k]*n[0] + m_y[k]*n[1] + m_z[k]*n[2] >= cosFOV)
+                out.push_back(k);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// OS_SKYINDEX.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: sky-partitioned star catalog for fast cone queries
+//              stars are binned on a cube-face grid (6 x G x G cells)
+//              and stored SoA, sorted by cell
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SKYINDEX_HPP
+#define OS_SKYINDEX_HPP
+
+#include <vector>
+
+class SkyIndex
+{
+public:
+    SkyIndex();
+
+    // build from N catalog entries (unit vectors in ECI + visual magnitude);
+    // halfFOV [rad] is the typical query radius and only sets the grid resolution
+    void Build(const double* x, const double* y, const double* z, const double* mag, int N, double halfFOV);
+
+    // indices (into the SoA arrays below) of every star within halfFOV [rad] of the unit vector n;
+    // visits the boresight's cell and grows through neighbouring cells that can overlap the cone
+    void Query(const double* n, double halfFOV, std::vector<int>& out) const;
+
+    int Size() const  { return (int) m_x.size(); };
+
+    // SoA catalog, sorted by cell
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::vector<double> m_mag;
+
+private:
+    int Cell(double x, double y, double z) const;
+
+    int m_G;                            // cells per face edge
+    std::vector<int> m_cellStart;       // first star of each cell, size 6*G*G + 1
+    std::vector<double> m_cellCenter;   // unit vector to the center of each cell (xyz)
+    std::vector<double> m_cellCosRadius; // cos/sin of the angular radius of each cell
+    std::vector<double> m_cellSinRadius;
+    std::vector<int> m_cellNeighbors;   // 8 per cell, across face edges too
+};
+
+#endif
@@ -0,0 +1,741 @@
+// OS_SOFTRASTER.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: CPU software renderer for GL-less batch nodes: opaque
+//              triangle meshes lit by directional lights, multithreaded,
+//              tile-binned, SIMD edge/depth evaluation into a visibility
+//              buffer that is shaded once per pixel
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_softraster.hpp"
+#include "os_starpsf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define OS_RASTER_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define OS_RASTER_LANES 4
+#else
+    #define OS_RASTER_LANES 1
+#endif
+
+static const uint32_t NO_TRIANGLE = 0xFFFFFFFFu;
+static const int CHUNK_SHIFT = 24;              // visibility id: chunk << 24 | triangle in chunk
+static const size_t VERTEX_BLOCK = 4096;
+
+// ------------------------------------------------------------------------
+// meshes and textures
+// ------------------------------------------------------------------------
+void SoftTexture::Sample(float u, float v, float rgb[3]) const{
+
+    if (pixels.empty()){
+        rgb[0] = rgb[1] = rgb[2] = 1.0f;
+        return;
+    }
+
+    // GL_REPEAT, nearest texel
+    u -= std::floor(u);
+    v -= std::floor(v);
+    int x = std::min(width - 1, (int) (u * width));
+    int y = std::min(height - 1, (int) (v * height));
+    const unsigned char* p = &pixels[((size_t) y * width + x) * channels];
+    for (int c = 0; c < 3; c++)
+        rgb[c] = p[std::min(c, channels - 1)] / 255.0f;
+}
+
+static void ReadAttribute(const unsigned char* vertex, const VertexAttribute& a, float out[3]){
+
+    const unsigned char* p = vertex + a.offset;
+    out[0] = out[1] = out[2] = 0.0f;
+    if (a.type == GL_FLOAT){
+        std::memcpy(out, p, sizeof(float) * std::min(3, (int) a.size));
+    }
+    else if (a.type == GL_INT_2_10_10_10_REV){
+        uint32_t packed;
+        std::memcpy(&packed, p, sizeof(packed));
+        for (int c = 0; c < 3; c++){
+            int32_t q = (int32_t) ((packed >> (10 * c)) & 0x3FF);
+            if (q & 0x200)
+                q -= 0x400;
+            out[c] = std::max(-1.0f, q / 511.0f);
+        }
+    }
+    else if (a.type == GL_UNSIGNED_BYTE){
+        for (int c = 0; c < std::min(3, (int) a.size); c++)
+            out[c] = a.normalized ? p[c] / 255.0f : (float) p[c];
+    }
+}
+
+bool SoftMesh::Build(const void* vertices, size_t vertexBytes, GLsizei stride, const std::vector<VertexAttribute>& attributes,
+                     const GLuint* sourceIndices, size_t nIndices, const std::vector<GLint>& first_,
+                     const std::vector<GLsizei>& count_){
+
+    if (attributes.size() < 2 || stride <= 0)
+        return false;
+
+    size_t n = vertexBytes / stride;
+    bool hasColor = attributes.size() > 2 && attributes[2].type == GL_UNSIGNED_BYTE;
+    bool hasUV = attributes.size() > 2 && attributes[2].type == GL_FLOAT && attributes[2].size == 2;
+    positions.resize(3*n);
+    normals.resize(3*n);
+    colors.assign(3*n, 1.0f);
+    texcoords.resize(hasUV ? 2*n : 0);
+
+    const unsigned char* base = (const unsigned char*) vertices;
+    for (size_t v = 0; v < n; v++){
+        const unsigned char* vertex = base + v*stride;
+        ReadAttribute(vertex, attributes[0], &positions[3*v]);
+        ReadAttribute(vertex, attributes[1], &normals[3*v]);
+        if (hasColor)
+            ReadAttribute(vertex, attributes[2], &colors[3*v]);
+        if (hasUV){
+            float uv[3];
+            ReadAttribute(vertex, attributes[2], uv);
+            texcoords[2*v] = uv[0];
+            texcoords[2*v + 1] = uv[1];
+        }
+    }
+
+    // one triangle list; non-indexed parts are vertex ranges
+    indices.clear();
+    first.clear();
+    count.clear();
+    for (size_t k = 0; k < first_.size(); k++){
+        first.push_back((int) indices.size());
+        for (GLsizei e = 0; e < count_[k]; e++)
+            indices.push_back(nIndices > 0 ? sourceIndices[first_[k] + e] : (uint32_t) (first_[k] + e));
+        count.push_back(count_[k]);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// worker pool
+// ------------------------------------------------------------------------
+SoftRasterizer::SoftRasterizer() :
+    m_width(0),
+    m_height(0),
+    m_vertices(0),
+    m_triangles(0),
+    m_tilesX(0),
+    m_tilesY(0),
+    m_splatSigma(0.7f),
+    m_shininess(32.0f),
+    m_resolved(false),
+    m_job(NULL),
+    m_jobSize(0),
+    m_next(0),
+    m_busy(0),
+    m_generation(0),
+    m_stop(false)
+{
+    std::memset(m_view, 0, sizeof(m_view));
+    m_view[0] = m_view[5] = m_view[10] = m_view[15] = 1.0f;
+    m_eye[0] = m_eye[1] = m_eye[2] = 0.0f;
+}
+
+SoftRasterizer::~SoftRasterizer(){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cvWork.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void SoftRasterizer::Start(int nThreads){
+
+    if (!m_threads.empty())
+        return;
+    if (nThreads <= 0)
+        nThreads = (int) std::max(1u, std::thread::hardware_concurrency());
+
+    // every chunk of triangles is binned by one item of work, a few per thread keep them balanced
+    m_chunks.resize(std::min(4 * nThreads, 1 << (32 - CHUNK_SHIFT)));
+    for (int t = 1; t < nThreads; t++)
+        m_threads.push_back(std::thread(&SoftRasterizer::Worker, this));
+}
+
+void SoftRasterizer::Work(){
+    for (int i = m_next++; i < m_jobSize; i = m_next++)
+        (*m_job)(i);
+}
+
+void SoftRasterizer::Worker(){
+    uint64_t seen = 0;
+    for (;;){
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvWork.wait(lock, [&](){ return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+        Work();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_cvDone.notify_all();
+    }
+}
+
+void SoftRasterizer::Run(int n, const std::function<void(int)>& fn){
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_jobSize = n;
+        m_next = 0;
+        m_busy = (int) m_threads.size();
+        m_generation++;
+    }
+    m_cvWork.notify_all();
+    Work();
+
+    // every worker checks in once per job, none can still be inside it when the next one starts
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvDone.wait(lock, [&](){ return m_busy == 0; });
+    m_job = NULL;
+}
+
+// ------------------------------------------------------------------------
+// frame
+// ------------------------------------------------------------------------
+void SoftRasterizer::Resize(int width, int height){
+    m_width = width;
+    m_height = height;
+    m_tilesX = (width + TILE - 1) / TILE;
+    m_tilesY = (height + TILE - 1) / TILE;
+    m_frame.assign((size_t) 3 * width * height, 0);
+    m_resolved = false;
+}
+
+void SoftRasterizer::Clear(){
+    if (m_chunks.empty())
+        Start(0);
+    m_draws.clear();
+    m_splats.clear();
+    m_vertices = 0;
+    m_triangles = 0;
+    m_resolved = false;
+}
+
+void SoftRasterizer::SetFrame(const float view[16], const float eye[3], const std::vector<SoftLight>& lights, float shininess){
+    std::memcpy(m_view, view, sizeof(m_view));
+    std::memcpy(m_eye, eye, sizeof(m_eye));
+    m_lights = lights;
+    m_shininess = shininess;
+}
+
+// column-major 4x4 products, as glm stores them
+static void Multiply(const float a[16], const float b[16], float out[16]){
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++){
+            float s = 0.0f;
+            for (int k = 0; k < 4; k++)
+                s += a[4*k + r] * b[4*c + k];
+            out[4*c + r] = s;
+        }
+}
+
+void SoftRasterizer::Draw(const SoftMesh& mesh, const float model[16], const float projection[16], const float* rgb){
+
+    if (mesh.indices.empty())
+        return;
+
+    DrawCall draw;
+    draw.mesh = &mesh;
+    std::memcpy(draw.model, model, sizeof(draw.model));
+    float modelView[16];
+    Multiply(m_view, model, modelView);
+    Multiply(projection, modelView, draw.mvp);
+    for (int c = 0; c < 3; c++)
+        for (int r = 0; r < 3; r++)
+            draw.normal[3*c + r] = model[4*c + r];
+    draw.unlit = (rgb != NULL);
+    for (int c = 0; c < 3; c++)
+        draw.rgb[c] = rgb != NULL ? rgb[c] : 0.0f;
+    draw.firstVertex = m_vertices;
+    draw.firstTriangle = m_triangles;
+    m_vertices += mesh.Vertices();
+    m_triangles += mesh.indices.size() / 3;
+    m_draws.push_back(draw);
+    m_resolved = false;
+}
+
+void SoftRasterizer::Splat(const float* stars, int N, const float projection[16], float sigma){
+
+    // w = 0: only the rotation of the view applies
+    for (int i = 0; i < N; i++){
+        const float* d = &stars[4*i];
+        float eye[3], clip[4];
+        for (int r = 0; r < 3; r++)
+            eye[r] = m_view[r]*d[0] + m_view[4 + r]*d[1] + m_view[8 + r]*d[2];
+        for (int r = 0; r < 4; r++)
+            clip[r] = projection[r]*eye[0] + projection[4 + r]*eye[1] + projection[8 + r]*eye[2];
+        if (clip[3] <= 0.0f)
+            continue;
+        m_splats.push_back((clip[0] / clip[3] * 0.5f + 0.5f) * m_width);
+        m_splats.push_back((clip[1] / clip[3] * 0.5f + 0.5f) * m_height);
+        m_splats.push_back(d[3]);
+    }
+    m_splatSigma = sigma;
+    m_resolved = false;
+}
+
+void SoftRasterizer::TransformVertices(int block){
+
+    size_t v0 = (size_t) block * VERTEX_BLOCK;
+    size_t v1 = std::min(m_vertices, v0 + VERTEX_BLOCK);
+
+    // the draw owning v0 (draws are few, vertices many)
+    size_t d = 0;
+    while (d + 1 < m_draws.size() && m_draws[d + 1].firstVertex <= v0)
+        d++;
+
+    for (size_t v = v0; v < v1; v++){
+        while (d + 1 < m_draws.size() && m_draws[d + 1].firstVertex <= v)
+            d++;
+        const DrawCall& draw = m_draws[d];
+        size_t local = v - draw.firstVertex;
+        const float* p = &draw.mesh->positions[3*local];
+        const float* n = &draw.mesh->normals[3*local];
+        const float* M = draw.mvp;
+
+        float clip[4];
+        for (int r = 0; r < 4; r++)
+            clip[r] = M[r]*p[0] + M[4 + r]*p[1] + M[8 + r]*p[2] + M[12 + r];
+
+        // window coordinates; vertices in front of the near plane (z >= -w) have w > 0
+        float* s = &m_screen[3*v];
+        if (clip[2] < -clip[3] || clip[3] <= 0.0f){
+            s[0] = s[1] = 0.0f;
+            s[2] = -1.0f;                   // behind the near plane, its triangles go through ClipNear
+        }
+        else{
+            float invW = 1.0f / clip[3];
+            s[0] = (clip[0] * invW * 0.5f + 0.5f) * m_width;
+            s[1] = (clip[1] * invW * 0.5f + 0.5f) * m_height;
+            s[2] = invW;
+        }
+
+        const float* W = draw.model;
+        for (int r = 0; r < 3; r++){
+            m_world[3*v + r] = W[r]*p[0] + W[4 + r]*p[1] + W[8 + r]*p[2] + W[12 + r];
+            m_normals[3*v + r] = draw.normal[r]*n[0] + draw.normal[3 + r]*n[1] + draw.normal[6 + r]*n[2];
+        }
+    }
+}
+
+void SoftRasterizer::SetupChunk(int chunk){
+
+    Chunk& c = m_chunks[chunk];
+    c.triangles.clear();
+    c.clips.clear();
+    c.bins.resize((size_t) m_tilesX * m_tilesY);
+    for (auto& bin : c.bins)
+        bin.clear();
+
+    // contiguous range of the frame's triangles: chunk order = submission order
+    size_t nChunks = m_chunks.size();
+    size_t t0 = m_triangles * chunk / nChunks;
+    size_t t1 = m_triangles * (chunk + 1) / nChunks;
+    size_t d = 0;
+    for (size_t t = t0; t < t1; t++){
+        while (d + 1 < m_draws.size() && m_draws[d + 1].firstTriangle <= t)
+            d++;
+        const DrawCall& draw = m_draws[d];
+        const uint32_t* index = &draw.mesh->indices[3*(t - draw.firstTriangle)];
+
+        Triangle tri;
+        float x[3], y[3], w[3];
+        bool clipped = false;
+        for (int i = 0; i < 3; i++){
+            tri.v[i] = (uint32_t) (draw.firstVertex + index[i]);
+            const float* s = &m_screen[3*tri.v[i]];
+            x[i] = s[0];
+            y[i] = s[1];
+            w[i] = s[2];
+            clipped |= (s[2] < 0.0f);
+        }
+        tri.draw = (uint32_t) d;
+        tri.clip = NO_CLIP;
+        if (clipped)
+            ClipNear(c, tri);
+        else
+            BinTriangle(c, tri, x, y, w);
+    }
+}
+
+// the part of a triangle in front of the near plane (z >= -w), as one or two pieces that
+// keep the source vertices for shading and carry their corners' barycentrics alongside
+void SoftRasterizer::ClipNear(Chunk& c, const Triangle& source){
+
+    const DrawCall& draw = m_draws[source.draw];
+    const float* M = draw.mvp;
+    float clip[3][4];
+    for (int i = 0; i < 3; i++){
+        const float* p = &draw.mesh->positions[3*(source.v[i] - draw.firstVertex)];
+        for (int r = 0; r < 4; r++)
+            clip[i][r] = M[r]*p[0] + M[4 + r]*p[1] + M[8 + r]*p[2] + M[12 + r];
+    }
+
+    // Sutherland-Hodgman against the one plane: 3 or 4 corners, or nothing
+    float poly[4][4], bary[4][3];
+    int n = 0;
+    for (int i = 0; i < 3; i++){
+        int j = (i + 1) % 3;
+        float di = clip[i][2] + clip[i][3], dj = clip[j][2] + clip[j][3];
+        if (di >= 0.0f){
+            for (int r = 0; r < 4; r++)
+                poly[n][r] = clip[i][r];
+            for (int k = 0; k < 3; k++)
+                bary[n][k] = (k == i) ? 1.0f : 0.0f;
+            n++;
+        }
+        if ((di >= 0.0f) != (dj >= 0.0f)){
+            float t = di / (di - dj);
+            for (int r = 0; r < 4; r++)
+                poly[n][r] = clip[i][r] + t * (clip[j][r] - clip[i][r]);
+            for (int k = 0; k < 3; k++)
+                bary[n][k] = (k == i) ? 1.0f - t : ((k == j) ? t : 0.0f);
+            n++;
+        }
+    }
+
+    float x[4], y[4], w[4];
+    for (int i = 0; i < n; i++){
+        if (poly[i][3] <= 0.0f)
+            return;
+        w[i] = 1.0f / poly[i][3];
+        x[i] = (poly[i][0] * w[i] * 0.5f + 0.5f) * m_width;
+        y[i] = (poly[i][1] * w[i] * 0.5f + 0.5f) * m_height;
+    }
+
+    // fan (0, k, k+1)
+    for (int k = 1; k + 1 < n; k++){
+        int corner[3] = {0, k, k + 1};
+        Triangle tri = source;
+        tri.clip = (uint32_t) (c.clips.size() / 12);
+        float px[3], py[3], pw[3];
+        for (int i = 0; i < 3; i++){
+            px[i] = x[corner[i]];
+            py[i] = y[corner[i]];
+            pw[i] = w[corner[i]];
+            c.clips.insert(c.clips.end(), bary[corner[i]], bary[corner[i]] + 3);
+        }
+        c.clips.insert(c.clips.end(), pw, pw + 3);
+        BinTriangle(c, tri, px, py, pw);
+    }
+}
+
+void SoftRasterizer::BinTriangle(Chunk& c, Triangle& tri, const float x[3], const float y[3], const float w[3]){
+
+    // pixel centers (px + 0.5, py + 0.5) inside the bounding box, clamped to the frame
+    float xmin = std::min(x[0], std::min(x[1], x[2])), xmax = std::max(x[0], std::max(x[1], x[2]));
+    float ymin = std::min(y[0], std::min(y[1], y[2])), ymax = std::max(y[0], std::max(y[1], y[2]));
+    tri.minX = std::max(0, (int) std::ceil(xmin - 0.5f));
+    tri.maxX = std::min(m_width - 1, (int) std::floor(xmax - 0.5f));
+    tri.minY = std::max(0, (int) std::ceil(ymin - 0.5f));
+    tri.maxY = std::min(m_height - 1, (int) std::floor(ymax - 0.5f));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+        return;
+
+    // E_i(x, y) for the edge from vertex i+1 to i+2, positive inside whatever the winding
+    float area = 0.0f;
+    for (int i = 0; i < 3; i++){
+        int a = (i + 1) % 3, b = (i + 2) % 3;
+        tri.A[i] = -(y[b] - y[a]);
+        tri.B[i] = x[b] - x[a];
+        tri.C[i] = (y[b] - y[a]) * x[a] - (x[b] - x[a]) * y[a];
+    }
+    area = tri.A[0]*x[0] + tri.B[0]*y[0] + tri.C[0];
+    if (std::fabs(area) < 1e-8f)
+        return;
+    if (area < 0.0f){
+        for (int i = 0; i < 3; i++){
+            tri.A[i] = -tri.A[i];
+            tri.B[i] = -tri.B[i];
+            tri.C[i] = -tri.C[i];
+        }
+        area = -area;
+    }
+    tri.invArea = 1.0f / area;
+
+    // pixels exactly on a shared edge belong to one of the two triangles only
+    for (int i = 0; i < 3; i++)
+        tri.topLeft[i] = tri.A[i] > 0.0f || (tri.A[i] == 0.0f && tri.B[i] < 0.0f);
+
+    // 1/w is affine in window coordinates: 1/w = sum_i E_i/area * (1/w_i)
+    for (int k = 0; k < 3; k++){
+        tri.Z[k] = 0.0f;
+        for (int i = 0; i < 3; i++){
+            float coeff = (k == 0 ? tri.A[i] : (k == 1 ? tri.B[i] : tri.C[i]));
+            tri.Z[k] += coeff * tri.invArea * w[i];
+        }
+    }
+
+    uint32_t id = (uint32_t) c.triangles.size();
+    c.triangles.push_back(tri);
+    for (int ty = tri.minY / TILE; ty <= tri.maxY / TILE; ty++)
+        for (int tx = tri.minX / TILE; tx <= tri.maxX / TILE; tx++)
+            c.bins[(size_t) ty * m_tilesX + tx].push_back(id);
+}
+
+// ------------------------------------------------------------------------
+// raster: coverage and 1/w of LANES pixels at once, nearest surface wins
+// ------------------------------------------------------------------------
+#if OS_RASTER_LANES == 8
+static inline void RasterSpan(const float* A, const float* B, const float* C, const float* Z, const bool* topLeft,
+                              float x0, float py, float* depth, uint32_t* ids, uint32_t id){
+    const __m256 lane = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    __m256 px = _mm256_add_ps(_mm256_set1_ps(x0), lane);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int i = 0; i < 3; i++){
+        __m256 e = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(A[i]), px), _mm256_set1_ps(B[i]*py + C[i]));
+        __m256 m = topLeft[i] ? _mm256_cmp_ps(e, zero, _CMP_GE_OQ) : _mm256_cmp_ps(e, zero, _CMP_GT_OQ);
+        inside = _mm256_and_ps(inside, m);
+    }
+    if (_mm256_movemask_ps(inside) == 0)
+        return;
+    __m256 z = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Z[0]), px), _mm256_set1_ps(Z[1]*py + Z[2]));
+    __m256 stored = _mm256_loadu_ps(depth);
+    __m256 closer = _mm256_and_ps(inside, _mm256_cmp_ps(z, stored, _CMP_GT_OQ));
+    _mm256_storeu_ps(depth, _mm256_blendv_ps(stored, z, closer));
+    __m256 storedIds = _mm256_loadu_ps((const float*) ids);
+    __m256 newIds = _mm256_castsi256_ps(_mm256_set1_epi32((int) id));
+    _mm256_storeu_ps((float*) ids, _mm256_blendv_ps(storedIds, newIds, closer));
+}
+#elif OS_RASTER_LANES == 4
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b){
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+static inline void RasterSpan(const float* A, const float* B, const float* C, const float* Z, const bool* topLeft,
+                              float x0, float py, float* depth, uint32_t* ids, uint32_t id){
+    const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 px = _mm_add_ps(_mm_set1_ps(x0), lane);
+    __m128 zero = _mm_setzero_ps();
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int i = 0; i < 3; i++){
+        __m128 e = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[i]), px), _mm_set1_ps(B[i]*py + C[i]));
+        __m128 m = topLeft[i] ? _mm_cmpge_ps(e, zero) : _mm_cmpgt_ps(e, zero);
+        inside = _mm_and_ps(inside, m);
+    }
+    if (_mm_movemask_ps(inside) == 0)
+        return;
+    __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Z[0]), px), _mm_set1_ps(Z[1]*py + Z[2]));
+    __m128 stored = _mm_loadu_ps(depth);
+    __m128 closer = _mm_and_ps(inside, _mm_cmpgt_ps(z, stored));
+    _mm_storeu_ps(depth, Select(closer, stored, z));
+    __m128 storedIds = _mm_loadu_ps((const float*) ids);
+    __m128 newIds = _mm_castsi128_ps(_mm_set1_epi32((int) id));
+    _mm_storeu_ps((float*) ids, Select(closer, storedIds, newIds));
+}
+#else
+static inline void RasterSpan(const float* A, const float* B, const float* C, const float* Z, const bool* topLeft,
+                              float x0, float py, float* depth, uint32_t* ids, uint32_t id){
+    float px = x0 + 0.5f;
+    for (int i = 0; i < 3; i++){
+        float e = A[i]*px + B[i]*py + C[i];
+        if (e < 0.0f || (e == 0.0f && !topLeft[i]))
+            return;
+    }
+    float z = Z[0]*px + Z[1]*py + Z[2];
+    if (z > depth[0]){
+        depth[0] = z;
+        ids[0] = id;
+    }
+}
+#endif
+
+void SoftRasterizer::RasterTile(int tile){
+
+    // visibility buffer of the tile: nearest 1/w and the triangle seen there
+    alignas(32) float depth[TILE * TILE];
+    alignas(32) uint32_t ids[TILE * TILE];
+    std::fill(depth, depth + TILE * TILE, 0.0f);
+    std::fill(ids, ids + TILE * TILE, NO_TRIANGLE);
+
+    int x0 = (tile % m_tilesX) * TILE;
+    int y0 = (tile / m_tilesX) * TILE;
+    int x1 = std::min(x0 + TILE, m_width);
+    int y1 = std::min(y0 + TILE, m_height);
+
+    for (size_t c = 0; c < m_chunks.size(); c++){
+        const Chunk& chunk = m_chunks[c];
+        for (uint32_t index : chunk.bins[tile]){
+            const Triangle& t = chunk.triangles[index];
+            uint32_t id = ((uint32_t) c << CHUNK_SHIFT) | index;
+
+            // spans start on a lane boundary of the tile, so they never leave its 64 columns
+            int bx0 = x0 + ((std::max(t.minX, x0) - x0) & ~(OS_RASTER_LANES - 1));
+            int bx1 = std::min(t.maxX, x1 - 1);
+            int by0 = std::max(t.minY, y0);
+            int by1 = std::min(t.maxY, y1 - 1);
+            for (int y = by0; y <= by1; y++){
+                float py = y + 0.5f;
+                size_t row = (size_t) (y - y0) * TILE;
+                for (int x = bx0; x <= bx1; x += OS_RASTER_LANES)
+                    RasterSpan(t.A, t.B, t.C, t.Z, t.topLeft, (float) x, py,
+                               depth + row + (x - x0), ids + row + (x - x0), id);
+            }
+        }
+    }
+
+    // shade every covered pixel once
+    for (int y = y0; y < y1; y++){
+        unsigned char* out = &m_frame[((size_t) y * m_width + x0) * 3];
+        const uint32_t* row = ids + (size_t) (y - y0) * TILE;
+        for (int x = x0; x < x1; x++, out += 3){
+            uint32_t id = row[x - x0];
+            if (id == NO_TRIANGLE){
+                out[0] = out[1] = out[2] = 0;
+                continue;
+            }
+            const Chunk& chunk = m_chunks[id >> CHUNK_SHIFT];
+            const Triangle& t = chunk.triangles[id & ((1u << CHUNK_SHIFT) - 1)];
+            Shade(t, t.clip == NO_CLIP ? NULL : &chunk.clips[12*t.clip], x + 0.5f, y + 0.5f, out);
+        }
+    }
+
+    if (!m_splats.empty())
+        SplatTile(x0, y0, x1, y1, ids);
+}
+
+// stars behind every body: only background pixels of the tile receive their PSF
+void SoftRasterizer::SplatTile(int x0, int y0, int x1, int y1, const uint32_t* ids){
+
+    int R = PSFRadius(m_splatSigma);
+    for (size_t s = 0; s < m_splats.size(); s += 3){
+        float cx = m_splats[s], cy = m_splats[s + 1], signal = m_splats[s + 2];
+        int px0 = std::max(x0, (int) std::floor(cx) - R), px1 = std::min(x1 - 1, (int) std::floor(cx) + R);
+        int py0 = std::max(y0, (int) std::floor(cy) - R), py1 = std::min(y1 - 1, (int) std::floor(cy) + R);
+        for (int y = py0; y <= py1; y++)
+            for (int x = px0; x <= px1; x++){
+                if (ids[(size_t) (y - y0) * TILE + (x - x0)] != NO_TRIANGLE)
+                    continue;
+                float value = signal * PixelFraction(x + 0.5f - cx, y + 0.5f - cy, m_splatSigma);
+                unsigned char* out = &m_frame[((size_t) y * m_width + x) * 3];
+                for (int c = 0; c < 3; c++)
+                    out[c] = (unsigned char) std::min(255.0f, out[c] + value * 255.0f + 0.5f);
+            }
+    }
+}
+
+static inline float Dot(const float a[3], const float b[3]){
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+static inline void Normalize(float v[3]){
+    float n = std::sqrt(Dot(v, v));
+    if (n > 0.0f){
+        v[0] /= n;
+        v[1] /= n;
+        v[2] /= n;
+    }
+}
+
+void SoftRasterizer::Shade(const Triangle& t, const float* clip, float px, float py, unsigned char* out) const{
+
+    const DrawCall& draw = m_draws[t.draw];
+    float rgb[3];
+    if (draw.unlit){
+        rgb[0] = draw.rgb[0];
+        rgb[1] = draw.rgb[1];
+        rgb[2] = draw.rgb[2];
+    }
+    else{
+        // perspective-correct barycentrics
+        float b[3], sum = 0.0f;
+        for (int i = 0; i < 3; i++){
+            float w = clip != NULL ? clip[9 + i] : m_screen[3*t.v[i] + 2];
+            b[i] = (t.A[i]*px + t.B[i]*py + t.C[i]) * t.invArea * w;
+            sum += b[i];
+        }
+        for (int i = 0; i < 3; i++)
+            b[i] /= sum;
+
+        // a near-clipped piece: from its corners to the source triangle's vertices
+        if (clip != NULL){
+            float piece[3] = {b[0], b[1], b[2]};
+            for (int k = 0; k < 3; k++)
+                b[k] = piece[0]*clip[k] + piece[1]*clip[3 + k] + piece[2]*clip[6 + k];
+        }
+
+        const SoftMesh& mesh = *draw.mesh;
+        float world[3] = {0, 0, 0}, n[3] = {0, 0, 0}, base[3] = {0, 0, 0}, uv[2] = {0, 0};
+        for (int i = 0; i < 3; i++){
+            size_t local = t.v[i] - draw.firstVertex;
+            for (int c = 0; c < 3; c++){
+                world[c] += b[i] * m_world[3*t.v[i] + c];
+                n[c] += b[i] * m_normals[3*t.v[i] + c];
+                base[c] += b[i] * mesh.colors[3*local + c];
+            }
+            if (!mesh.texcoords.empty()){
+                uv[0] += b[i] * mesh.texcoords[2*local];
+                uv[1] += b[i] * mesh.texcoords[2*local + 1];
+            }
+        }
+        Normalize(n);
+        float specularColor[3] = {1.0f, 1.0f, 1.0f};
+        if (!mesh.texcoords.empty()){
+            float texel[3];
+            mesh.diffuse.Sample(uv[0], uv[1], texel);
+            for (int c = 0; c < 3; c++)
+                base[c] *= texel[c];
+            mesh.specular.Sample(uv[0], uv[1], specularColor);
+        }
+
+        // Phong per directional light, as in the CAD fragment shaders
+        float view[3] = {m_eye[0] - world[0], m_eye[1] - world[1], m_eye[2] - world[2]};
+        Normalize(view);
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+        for (const SoftLight& light : m_lights){
+            float diffuse = std::max(Dot(n, light.direction), 0.0f);
+            float nl = Dot(n, light.direction);
+            float reflected[3];
+            for (int c = 0; c < 3; c++)
+                reflected[c] = 2.0f * nl * n[c] - light.direction[c];
+            float specular = std::pow(std::max(Dot(view, reflected), 0.0f), m_shininess);
+            for (int c = 0; c < 3; c++)
+                rgb[c] += (light.ambient + light.diffuse * diffuse) * base[c] + light.specular * specular * specularColor[c];
+        }
+    }
+
+    for (int c = 0; c < 3; c++)
+        out[c] = (unsigned char) (std::min(1.0f, std::max(0.0f, rgb[c])) * 255.0f + 0.5f);
+}
+
+void SoftRasterizer::Resolve(){
+
+    if (m_resolved || m_width <= 0 || m_height <= 0)
+        return;
+    if (m_chunks.empty())
+        Start(0);
+
+    m_screen.resize(3*m_vertices);
+    m_world.resize(3*m_vertices);
+    m_normals.resize(3*m_vertices);
+
+    // vertices, then triangle setup and binning per chunk, then tiles independently
+    std::function<void(int)> transform = [this](int block){ TransformVertices(block); };
+    std::function<void(int)> setup = [this](int chunk){ SetupChunk(chunk); };
+    std::function<void(int)> raster = [this](int tile){ RasterTile(tile); };
+    Run((int) ((m_vertices + VERTEX_BLOCK - 1) / VERTEX_BLOCK), transform);
+    Run((int) m_chunks.size(), setup);
+    Run(m_tilesX * m_tilesY, raster);
+    m_resolved = true;
+}
@@ -0,0 +1,181 @@
+// OS_SOFTRASTER.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: CPU software renderer for GL-less batch nodes: opaque
+//              triangle meshes lit by directional lights, multithreaded,
+//              tile-binned, SIMD edge/depth evaluation into a visibility
+//              buffer that is shaded once per pixel
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SOFTRASTER_HPP
+#define OS_SOFTRASTER_HPP
+
+#include "os_mesh.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SoftTexture
+{
+    int width;
+    int height;
+    int channels;
+    std::vector<unsigned char> pixels;          // rows as decoded (first row = v 0)
+
+    SoftTexture() : width(0), height(0), channels(0) {};
+    void Sample(float u, float v, float rgb[3]) const;
+};
+
+// CPU copy of a CAD mesh, unpacked from the GPU vertex formats
+struct SoftMesh
+{
+    std::vector<float> positions;               // xyz (model frame)
+    std::vector<float> normals;                 // xyz
+    std::vector<float> colors;                  // rgb, 1 without a color attribute
+    std::vector<float> texcoords;               // uv, empty without texture coordinates
+    std::vector<uint32_t> indices;              // triangle list over all parts
+    std::vector<int> first;                     // per part, into indices
+    std::vector<int> count;
+    SoftTexture diffuse;
+    SoftTexture specular;
+
+    // same inputs as Mesh::UploadRaw (location 0 position, 1 normal, 2 color or texture coordinates)
+    bool Build(const void* vertices, size_t vertexBytes, GLsizei stride, const std::vector<VertexAttribute>& attributes,
+               const GLuint* sourceIndices, size_t nIndices, const std::vector<GLint>& first, const std::vector<GLsizei>& count);
+    size_t Vertices() const     { return positions.size() / 3; };
+};
+
+// directional light, direction towards the light (GL world frame)
+struct SoftLight
+{
+    float direction[3];
+    float ambient;
+    float diffuse;
+    float specular;
+};
+
+class SoftRasterizer
+{
+public:
+    static const int TILE = 64;
+
+    SoftRasterizer();
+    ~SoftRasterizer();
+
+    // nThreads <= 0: every core
+    void Start(int nThreads);
+    void Resize(int width, int height);
+
+    // a new frame: nothing queued, background black
+    void Clear();
+
+    // camera and lights of the frame (column-major view matrix, eye in GL world coordinates)
+    void SetFrame(const float view[16], const float eye[3], const std::vector<SoftLight>& lights, float shininess);
+
+    // queue a draw; the mesh must outlive Resolve. Phong lit, or a constant color when rgb is given
+    void Draw(const SoftMesh& mesh, const float model[16], const float projection[16], const float* rgb = NULL);
+
+    // queue N stars (unit direction in GL world frame, total signal) as Gaussian PSFs of sigma [pix]
+    // at infinity, added onto the background after shading (see StarSplat)
+    void Splat(const float* stars, int N, const float projection[16], float sigma);
+
+    // rasterize and shade everything queued since Clear into the frame (again only after new draws)
+    void Resolve();
+
+    // RGB8, bottom-up rows like glReadPixels
+    const unsigned char* Pixels() const     { return m_frame.data(); };
+
+    int m_width;
+    int m_height;
+
+private:
+    struct DrawCall
+    {
+        const SoftMesh* mesh;
+        float model[16];
+        float mvp[16];
+        float normal[9];                        // rotation part of model, renormalized after use
+        bool unlit;
+        float rgb[3];
+        size_t firstVertex;                     // into the frame vertex arrays
+        size_t firstTriangle;                   // into the frame triangle numbering
+    };
+
+    struct Triangle
+    {
+        float A[3], B[3], C[3];                 // edge functions, >= 0 inside, E_i = 0 on the edge opposite vertex i
+        float Z[3];                             // 1/w plane over the window
+        float invArea;
+        bool topLeft[3];
+        int minX, minY, maxX, maxY;
+        uint32_t draw;
+        uint32_t v[3];                          // frame vertex indices
+        uint32_t clip;                          // NO_CLIP, or record in Chunk::clips
+    };
+
+    static const uint32_t NO_CLIP = 0xFFFFFFFFu;
+
+    struct Chunk
+    {
+        std::vector<Triangle> triangles;
+        std::vector< std::vector<uint32_t> > bins;      // per tile, indices into triangles
+        std::vector<float> clips;               // per near-clipped piece: barycentrics of its corners
+                                                // in the source triangle (3x3), then their 1/w (3)
+    };
+
+    // persistent worker pool: fn(0) ... fn(n-1), the caller included
+    void Run(int n, const std::function<void(int)>& fn);
+    void Worker();
+    void Work();
+
+    void TransformVertices(int block);
+    void SetupChunk(int chunk);
+    void ClipNear(Chunk& c, const Triangle& source);
+    void BinTriangle(Chunk& c, Triangle& tri, const float x[3], const float y[3], const float w[3]);
+    void RasterTile(int tile);
+    void Shade(const Triangle& t, const float* clip, float px, float py, unsigned char* out) const;
+    void SplatTile(int x0, int y0, int x1, int y1, const uint32_t* ids);
+
+    std::vector<DrawCall> m_draws;
+    std::vector<float> m_screen;                // per frame vertex: x, y [pix], 1/w
+    std::vector<float> m_world;                 // xyz
+    std::vector<float> m_normals;               // xyz
+    std::vector<Chunk> m_chunks;
+    size_t m_vertices;
+    size_t m_triangles;
+    int m_tilesX;
+    int m_tilesY;
+    std::vector<float> m_splats;                // per star: x, y [pix], signal
+    float m_splatSigma;
+
+    float m_view[16];
+    float m_eye[3];
+    std::vector<SoftLight> m_lights;
+    float m_shininess;
+    std::vector<unsigned char> m_frame;
+    bool m_resolved;                            // m_frame is up to date with the queued draws
+
+    // worker pool
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cvWork;
+    std::condition_variable m_cvDone;
+    const std::function<void(int)>* m_job;
+    int m_jobSize;
+    std::atomic<int> m_next;
+    int m_busy;                                 // workers not yet done with the current job
+    uint64_t m_generation;
+    bool m_stop;
+};
+
+#endif
@@ -0,0 +1,171 @@
+// OS_SPHERE.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: sphere meshes for textured bodies (Earth, moon, sun):
+//              bulk equirectangular UV kernel and a procedural UV sphere
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_sphere.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define OS_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define OS_SIMD_WIDTH 4
+#else
+    #define OS_SIMD_WIDTH 1
+#endif
+
+static const double PI = 3.14159265358979323846;
+static const float PI_F = (float) PI;
+
+// minimax fit of atan(a)/a on [0,1] in s = a^2, |error| < 1e-7 rad
+static const float ATAN_P[6] = {0.99997726f, -0.33262347f, 0.19354346f, -0.11643287f, 0.05265332f, -0.01172120f};
+
+// ------------------------------------------------------------------------
+// scalar reference (also handles the tail of the SIMD loop)
+// ------------------------------------------------------------------------
+
+// same range reduction and polynomial as the SIMD path
+static inline float Atan2(float y, float x){
+    float ax = std::fabs(x), ay = std::fabs(y);
+    float mx = std::max(ax, ay), mn = std::min(ax, ay);
+    float a = mx > 0.0f ? mn / mx : 0.0f;
+    float s = a*a;
+    float r = a*(((((ATAN_P[5]*s + ATAN_P[4])*s + ATAN_P[3])*s + ATAN_P[2])*s + ATAN_P[1])*s + ATAN_P[0]);
+    if (ay > ax) r = 0.5f*PI_F - r;
+    if (x < 0.0f) r = PI_F - r;
+    return std::signbit(y) ? -r : r;
+}
+
+static void SphereUVScalar(const float* x, const float* y, const float* z, int first, int N, float* u, float* v){
+    for (int i = first; i < N; i++){
+        float rho = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+        u[i] = Atan2(y[i], x[i]) * (0.5f/PI_F) + 0.5f;
+        v[i] = 0.5f - Atan2(z[i], rho) * (1.0f/PI_F);
+    }
+}
+
+// ------------------------------------------------------------------------
+// SIMD helpers: one vector register holds OS_SIMD_WIDTH floats
+// ------------------------------------------------------------------------
+#if OS_SIMD_WIDTH == 8
+    typedef __m256 vf;
+    static inline vf Load(const float* p)               { return _mm256_loadu_ps(p); }
+    static inline void Store(float* p, vf a)            { _mm256_storeu_ps(p, a); }
+    static inline vf Set1(float a)                      { return _mm256_set1_ps(a); }
+    static inline vf Add(vf a, vf b)                    { return _mm256_add_ps(a, b); }
+    static inline vf Sub(vf a, vf b)                    { return _mm256_sub_ps(a, b); }
+    static inline vf Mul(vf a, vf b)                    { return _mm256_mul_ps(a, b); }
+    static inline vf Div(vf a, vf b)                    { return _mm256_div_ps(a, b); }
+    static inline vf Sqrt(vf a)                         { return _mm256_sqrt_ps(a); }
+    static inline vf Min(vf a, vf b)                    { return _mm256_min_ps(a, b); }
+    static inline vf Max(vf a, vf b)                    { return _mm256_max_ps(a, b); }
+    static inline vf And(vf a, vf b)                    { return _mm256_and_ps(a, b); }
+    static inline vf AndNot(vf a, vf b)                 { return _mm256_andnot_ps(a, b); }
+    static inline vf Xor(vf a, vf b)                    { return _mm256_xor_ps(a, b); }
+    static inline vf Greater(vf a, vf b)                { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline vf Select(vf mask, vf a, vf b)        { return _mm256_blendv_ps(b, a, mask); }
+#elif OS_SIMD_WIDTH == 4
+    typedef __m128 vf;
+    static inline vf Load(const float* p)               { return _mm_loadu_ps(p); }
+    static inline void Store(float* p, vf a)            { _mm_storeu_ps(p, a); }
+    static inline vf Set1(float a)                      { return _mm_set1_ps(a); }
+    static inline vf Add(vf a, vf b)                    { return _mm_add_ps(a, b); }
+    static inline vf Sub(vf a, vf b)                    { return _mm_sub_ps(a, b); }
+    static inline vf Mul(vf a, vf b)                    { return _mm_mul_ps(a, b); }
+    static inline vf Div(vf a, vf b)                    { return _mm_div_ps(a, b); }
+    static inline vf Sqrt(vf a)                         { return _mm_sqrt_ps(a); }
+    static inline vf Min(vf a, vf b)                    { return _mm_min_ps(a, b); }
+    static inline vf Max(vf a, vf b)                    { return _mm_max_ps(a, b); }
+    static inline vf And(vf a, vf b)                    { return _mm_and_ps(a, b); }
+    static inline vf AndNot(vf a, vf b)                 { return _mm_andnot_ps(a, b); }
+    static inline vf Xor(vf a, vf b)                    { return _mm_xor_ps(a, b); }
+    static inline vf Greater(vf a, vf b)                { return _mm_cmpgt_ps(a, b); }
+    static inline vf Select(vf mask, vf a, vf b)        { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#endif
+
+#if OS_SIMD_WIDTH > 1
+static inline vf Atan2(vf y, vf x){
+    vf sign = Set1(-0.0f);
+    vf zero = Set1(0.0f);
+    vf ax = AndNot(sign, x), ay = AndNot(sign, y);
+    vf mx = Max(ax, ay), mn = Min(ax, ay);
+    vf a = And(Greater(mx, zero), Div(mn, Max(mx, Set1(1e-30f))));
+    vf s = Mul(a, a);
+    vf p = Set1(ATAN_P[5]);
+    for (int k = 4; k >= 0; k--)
+        p = Add(Mul(p, s), Set1(ATAN_P[k]));
+    vf r = Mul(a, p);
+    r = Select(Greater(ay, ax), Sub(Set1(0.5f*PI_F), r), r);
+    r = Select(Greater(zero, x), Sub(Set1(PI_F), r), r);
+    return Xor(r, And(y, sign));
+}
+#endif
+
+// ------------------------------------------------------------------------
+// public kernels
+// ------------------------------------------------------------------------
+void SphereUV(const float* x, const float* y, const float* z, int N, float* u, float* v){
+    int i = 0;
+#if OS_SIMD_WIDTH > 1
+    vf half = Set1(0.5f), iPi = Set1(1.0f/PI_F), i2Pi = Set1(0.5f/PI_F);
+    for (; i + OS_SIMD_WIDTH <= N; i += OS_SIMD_WIDTH){
+        vf xi = Load(x + i), yi = Load(y + i), zi = Load(z + i);
+        vf rho = Sqrt(Add(Mul(xi, xi), Mul(yi, yi)));
+        Store(u + i, Add(Mul(Atan2(yi, xi), i2Pi), half));
+        Store(v + i, Sub(half, Mul(Atan2(zi, rho), iPi)));
+    }
+#endif
+    SphereUVScalar(x, y, z, i, N, u, v);
+}
+
+void BuildSphere(int level, float radius, std::vector<float>& vertices, std::vector<unsigned int>& indices){
+
+    level = std::min(std::max(level, 0), 8);
+    int stacks = 4 << level;
+    int slices = 2*stacks;
+
+    // row i runs north to south (v = i/stacks), column j west to east from -180 deg (u = j/slices)
+    vertices.resize((size_t) 8*(stacks + 1)*(slices + 1));
+    float* p = vertices.data();
+    for (int i = 0; i <= stacks; i++){
+        double lat = 0.5*PI - PI*i/stacks;
+        for (int j = 0; j <= slices; j++){
+            double lon = -PI + 2.0*PI*j/slices;
+            float n[3] = {(float) (cos(lat)*cos(lon)), (float) (cos(lat)*sin(lon)), (float) sin(lat)};
+            p[0] = radius*n[0]; p[1] = radius*n[1]; p[2] = radius*n[2];
+            p[3] = n[0];        p[4] = n[1];        p[5] = n[2];
+            p[6] = (float) j/slices;
+            p[7] = (float) i/stacks;
+            p += 8;
+        }
+    }
+
+    // counter-clockwise seen from outside; the pole rows drop their degenerate triangle
+    indices.clear();
+    indices.reserve((size_t) 6*stacks*slices);
+    for (int i = 0; i < stacks; i++){
+        for (int j = 0; j < slices; j++){
+            unsigned int a = i*(slices + 1) + j;        // north-west
+            unsigned int b = a + slices + 1;            // south-west
+            unsigned int c = b + 1;                     // south-east
+            unsigned int d = a + 1;                     // north-east
+            if (i != stacks - 1){
+                indices.push_back(a); indices.push_back(b); indices.push_back(c);
+            }
+            if (i != 0){
+                indices.push_back(a); indices.push_back(c); indices.push_back(d);
+            }
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// OS_SPHERE.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: sphere meshes for textured bodies (Earth, moon, sun):
+//              bulk equirectangular UV kernel and a procedural UV sphere
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_SPHERE_HPP
+#define OS_SPHERE_HPP
+
+#include <vector>
+
+// texture coordinates of points around the origin (need not be unit length)
+// u = atan2(y,x)/2pi + 0.5, v = 0.5 - atan2(z, hypot(x,y))/pi, |error| < 1e-6
+void SphereUV(const float* x, const float* y, const float* z, int N, float* u, float* v);
+
+// UV sphere of the given radius: stacks = 4*2^level (level clamped to 0..8), slices = 2*stacks
+// vertices: (stacks+1)*(slices+1) x [position, normal, uv]; indices: 32 bit triangle list
+// the seam column is duplicated so u runs 0..1 without wrapping
+void BuildSphere(int level, float radius, std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
+#endif
@@ -0,0 +1,179 @@
+// OS_STARFIELD.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: instanced star-field renderer, the whole field is drawn
+//              with a single glDrawElementsInstanced
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_starfield.hpp"
+#include "os_glprogram.hpp"
+
+#include <cstddef>
+
+static const char* STARFIELD_VS = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aDirection;   // per instance: unit vector to star (GL frame)
+layout (location = 2) in vec3 aRGB;         // per instance: radiometric color
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform float distance;
+uniform float scale;
+
+out vec3 RGB;
+
+void main()
+{
+    // equivalent to model = translate(distance*n) * scale(scale)
+    vec3 r = distance * aDirection + scale * aPos;
+    gl_Position = projection * view * vec4(r, 1.0);
+    RGB = aRGB;
+}
+)";
+
+static const char* STARFIELD_FS = R"(
+#version 330 core
+in vec3 RGB;
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(RGB, 1.0);
+}
+)";
+
+// 6 floats per instance: direction (3), rgb (3)
+static const int INSTANCE_FLOATS = 6;
+
+StarField::StarField() :
+    m_initialized(false),
+    m_program(0),
+    m_instanceVBO(0),
+    m_VAO(0),
+    m_meshVBO(0),
+    m_meshEBO(0),
+    m_meshStride(0),
+    m_indexCount(0),
+    m_nInstances(0),
+    m_capacity(0)
+{
+}
+
+bool StarField::Create(GLuint meshVBO, GLuint meshEBO, GLsizei meshStride, GLsizei meshIndexCount){
+
+    Delete();
+
+    m_program = CompileProgram(STARFIELD_VS, STARFIELD_FS, "starfield");
+    if (m_program == 0)
+        return false;
+    m_locProjection = glGetUniformLocation(m_program, "projection");
+    m_locView = glGetUniformLocation(m_program, "view");
+    m_locDistance = glGetUniformLocation(m_program, "distance");
+    m_locScale = glGetUniformLocation(m_program, "scale");
+
+    glGenBuffers(1, &m_instanceVBO);
+
+    m_meshVBO = meshVBO;
+    m_meshEBO = meshEBO;
+    m_meshStride = meshStride;
+    m_indexCount = meshIndexCount;
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    // per-vertex mesh position, indexed through the mesh's element buffer
+    glBindBuffer(GL_ARRAY_BUFFER, meshVBO);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEBO);
+
+    // per-instance direction and rgb
+    GLsizei STRIDE_INSTANCE = INSTANCE_FLOATS * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, STRIDE_INSTANCE, (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, STRIDE_INSTANCE, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_initialized = true;
+    return true;
+}
+
+void StarField::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_instanceVBO);
+    glDeleteProgram(m_program);
+    m_VAO = 0;
+    m_meshVBO = 0;
+    m_meshEBO = 0;
+    m_meshStride = 0;
+    m_indexCount = 0;
+    m_program = 0;
+    m_instanceVBO = 0;
+    m_nInstances = 0;
+    m_capacity = 0;
+    m_initialized = false;
+}
+
+bool StarField::Current(GLuint meshVBO, GLuint meshEBO, GLsizei meshStride, GLsizei meshIndexCount) const{
+    return m_initialized && m_meshVBO == meshVBO && m_meshEBO == meshEBO &&
+           m_meshStride == meshStride && m_indexCount == meshIndexCount;
+}
+
+void StarField::Upload(const float* directions, const float* rgb, int N){
+
+    // interleave into one instance stream
+    m_staging.resize((size_t) INSTANCE_FLOATS * N);
+    for (int i = 0; i < N; i++){
+        float* dst = &m_staging[(size_t) INSTANCE_FLOATS * i];
+        dst[0] = directions[3*i + 0];
+        dst[1] = directions[3*i + 1];
+        dst[2] = directions[3*i + 2];
+        dst[3] = rgb[3*i + 0];
+        dst[4] = rgb[3*i + 1];
+        dst[5] = rgb[3*i + 2];
+    }
+
+    // grow geometrically; orphan the old storage so the driver never stalls on it
+    if (N > m_capacity)
+        m_capacity = N < 2*m_capacity ? 2*m_capacity : N;
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t) INSTANCE_FLOATS * m_capacity * sizeof(float), NULL, GL_STREAM_DRAW);
+    size_t bytes = m_staging.size() * sizeof(float);
+    if (bytes > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_staging.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_nInstances = N;
+}
+
+void StarField::Draw(const float* projection, const float* view, float distance, float scale){
+
+    if (m_initialized == false || m_nInstances == 0)
+        return;
+
+    glUseProgram(m_program);
+    glUniformMatrix4fv(m_locProjection, 1, GL_FALSE, projection);
+    glUniformMatrix4fv(m_locView, 1, GL_FALSE, view);
+    glUniform1f(m_locDistance, distance);
+    glUniform1f(m_locScale, scale);
+
+    glBindVertexArray(m_VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0, m_nInstances);
+    glBindVertexArray(0);
+}
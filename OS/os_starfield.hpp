@@ -0,0 +1,59 @@
+// OS_STARFIELD.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: instanced star-field renderer, the whole field is drawn
+//              with a single glDrawElementsInstanced
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_STARFIELD_HPP
+#define OS_STARFIELD_HPP
+
+#include "include/glad/glad.h"
+
+#include <vector>
+
+class StarField
+{
+public:
+    StarField();
+
+    // wrap the indexed star mesh (position = first 3 floats of each 'meshStride'-byte vertex) with an instanced VAO
+    bool Create(GLuint meshVBO, GLuint meshEBO, GLsizei meshStride, GLsizei meshIndexCount);
+    void Delete();
+
+    // the VAO still wraps these mesh buffers (a reloaded star mesh needs Create again)
+    bool Current(GLuint meshVBO, GLuint meshEBO, GLsizei meshStride, GLsizei meshIndexCount) const;
+
+    // upload N instances: unit direction (GL frame, xyz) and radiometric color (rgb)
+    void Upload(const float* directions, const float* rgb, int N);
+
+    // projection/view are column-major 4x4, stars are placed at 'distance' and scaled by 'scale'
+    void Draw(const float* projection, const float* view, float distance, float scale);
+
+    bool m_initialized;
+
+private:
+    GLuint m_program;
+    GLuint m_instanceVBO;
+    GLuint m_VAO;
+    GLuint m_meshVBO;
+    GLuint m_meshEBO;
+    GLsizei m_meshStride;
+    GLsizei m_indexCount;
+    int m_nInstances;
+    int m_capacity;
+
+    GLint m_locProjection;
+    GLint m_locView;
+    GLint m_locDistance;
+    GLint m_locScale;
+
+    std::vector<float> m_staging;
+};
+
+#endif
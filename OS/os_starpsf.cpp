@@ -0,0 +1,255 @@
+// OS_STARPSF.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: stars as sub-pixel Gaussian point spread functions: star
+//              photometry (magnitude to collected signal) through a
+//              lookup table, and a point-sprite pass that accumulates
+//              the pixel-integrated PSF of the whole field in one draw
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_starpsf.hpp"
+#include "os_glprogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// one vertex per star, the sprite covers the PSF out to 3 sigma around its sub-pixel center
+static const char* SPLAT_VS = R"(
+#version 330 core
+layout (location = 0) in vec4 aStar;        // unit direction (GL frame), visual magnitude
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec2 viewport;
+uniform vec2 lutScale;                      // magnitude -> LUT texture coordinate
+uniform float pointSize;
+uniform sampler1D signalLUT;
+
+out vec2 center;
+out float signal;
+
+void main()
+{
+    // w = 0: a point at infinity, only the camera rotation applies
+    vec4 p = projection * view * vec4(aStar.xyz, 0.0);
+    center = (p.xy / p.w * 0.5 + 0.5) * viewport;
+    signal = texture(signalLUT, aStar.w * lutScale.x + lutScale.y).r;
+
+    // just inside the far plane: behind every body, never clipped by it
+    gl_Position = vec4(p.xy, 0.999999 * p.w, p.w);
+    gl_PointSize = pointSize;
+}
+)";
+
+static const char* SPLAT_FS = R"(
+#version 330 core
+in vec2 center;
+in float signal;
+
+uniform float sigma;
+
+out vec4 FragColor;
+
+// Abramowitz & Stegun 7.1.26, |error| < 1.5e-7
+float Erf(float x)
+{
+    float t = 1.0 / (1.0 + 0.3275911 * abs(x));
+    float y = 1.0 - t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 + t * (-1.453152027 + t * 1.061405429)))) * exp(-x * x);
+    return sign(x) * y;
+}
+
+void main()
+{
+    // Gaussian integrated over this pixel's square
+    vec2 d = gl_FragCoord.xy - center;
+    float k = 0.70710678 / sigma;
+    float ex = 0.5 * (Erf((d.x + 0.5) * k) - Erf((d.x - 0.5) * k));
+    float ey = 0.5 * (Erf((d.y + 0.5) * k) - Erf((d.y - 0.5) * k));
+    FragColor = vec4(vec3(signal * ex * ey), 1.0);
+}
+)";
+
+// ------------------------------------------------------------------------
+// photometry
+// ------------------------------------------------------------------------
+double StarPhotometry::Electrons(double mag) const{
+    return zeroPointFlux * std::pow(10.0, -0.4 * mag) * aperture * exposure * efficiency;
+}
+
+const float MagnitudeLUT::MAG_MIN = -2.0f;
+const float MagnitudeLUT::MAG_MAX = 14.0f;
+
+MagnitudeLUT::MagnitudeLUT(){
+    Build(StarPhotometry());
+}
+
+void MagnitudeLUT::Build(const StarPhotometry& photometry){
+    m_table.resize(SIZE);
+    for (int i = 0; i < SIZE; i++){
+        double mag = MAG_MIN + (MAG_MAX - MAG_MIN) * i / (SIZE - 1);
+        m_table[i] = (float) (photometry.Electrons(mag) / photometry.fullWell);
+    }
+}
+
+float MagnitudeLUT::Signal(float mag) const{
+    float x = (mag - MAG_MIN) / (MAG_MAX - MAG_MIN) * (SIZE - 1);
+    x = std::min((float) (SIZE - 1), std::max(0.0f, x));
+    int i = std::min(SIZE - 2, (int) x);
+    float a = x - i;
+    return (1.0f - a) * m_table[i] + a * m_table[i + 1];
+}
+
+float PixelFraction(float dx, float dy, float sigma){
+    float k = 0.70710678f / sigma;
+    float ex = 0.5f * (std::erf((dx + 0.5f) * k) - std::erf((dx - 0.5f) * k));
+    float ey = 0.5f * (std::erf((dy + 0.5f) * k) - std::erf((dy - 0.5f) * k));
+    return ex * ey;
+}
+
+int PSFRadius(float sigma){
+    return (int) std::ceil(3.0f * sigma + 0.5f);
+}
+
+// ------------------------------------------------------------------------
+// splat pass
+// ------------------------------------------------------------------------
+StarSplat::StarSplat() :
+    m_initialized(false),
+    m_program(0),
+    m_VAO(0),
+    m_VBO(0),
+    m_lut(0),
+    m_nStars(0),
+    m_capacity(0),
+    m_maxPointSize(1.0f)
+{
+}
+
+bool StarSplat::Create(){
+
+    Delete();
+
+    m_program = CompileProgram(SPLAT_VS, SPLAT_FS, "starsplat");
+    if (m_program == 0)
+        return false;
+    m_locProjection = glGetUniformLocation(m_program, "projection");
+    m_locView = glGetUniformLocation(m_program, "view");
+    m_locViewport = glGetUniformLocation(m_program, "viewport");
+    m_locLUTScale = glGetUniformLocation(m_program, "lutScale");
+    m_locPointSize = glGetUniformLocation(m_program, "pointSize");
+    m_locSigma = glGetUniformLocation(m_program, "sigma");
+    glUseProgram(m_program);
+    glUniform1i(glGetUniformLocation(m_program, "signalLUT"), 0);
+    glUseProgram(0);
+
+    GLfloat range[2];
+    glGetFloatv(GL_POINT_SIZE_RANGE, range);
+    m_maxPointSize = range[1];
+
+    glGenBuffers(1, &m_VBO);
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // filtered lookups between entries, the end entries beyond the range
+    glGenTextures(1, &m_lut);
+    glBindTexture(GL_TEXTURE_1D, m_lut);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+
+    m_initialized = true;
+    return true;
+}
+
+void StarSplat::Delete(){
+
+    if (m_initialized == false)
+        return;
+
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_VBO);
+    glDeleteTextures(1, &m_lut);
+    glDeleteProgram(m_program);
+    m_VAO = 0;
+    m_VBO = 0;
+    m_lut = 0;
+    m_program = 0;
+    m_nStars = 0;
+    m_capacity = 0;
+    m_initialized = false;
+}
+
+void StarSplat::SetLUT(const MagnitudeLUT& lut){
+
+    if (m_initialized == false)
+        return;
+
+    glBindTexture(GL_TEXTURE_1D, m_lut);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, (GLsizei) lut.m_table.size(), 0, GL_RED, GL_FLOAT, lut.m_table.data());
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
+
+void StarSplat::Upload(const float* stars, int N){
+
+    // grow geometrically; orphan the old storage so the driver never stalls on it
+    if (N > m_capacity)
+        m_capacity = N < 2*m_capacity ? 2*m_capacity : N;
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t) 4 * m_capacity * sizeof(float), NULL, GL_STREAM_DRAW);
+    if (N > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (size_t) 4 * N * sizeof(float), stars);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_nStars = N;
+}
+
+// leaves its program and texture bindings behind (RenderState must be invalidated)
+void StarSplat::Draw(const float* projection, const float* view, int viewportWidth, int viewportHeight, float sigma){
+
+    if (m_initialized == false || m_nStars == 0)
+        return;
+
+    // texel centers: entry i at magnitude MAG_MIN + i * step
+    float step = (MagnitudeLUT::MAG_MAX - MagnitudeLUT::MAG_MIN) / (MagnitudeLUT::SIZE - 1);
+    float scale = 1.0f / (step * MagnitudeLUT::SIZE);
+    float offset = 0.5f / MagnitudeLUT::SIZE - MagnitudeLUT::MAG_MIN * scale;
+
+    // a sprite of 2 * radius + 1 pixels holds every pixel center the PSF reaches, wherever its center falls
+    float pointSize = std::min(m_maxPointSize, (float) (2 * PSFRadius(sigma) + 1));
+
+    glUseProgram(m_program);
+    glUniformMatrix4fv(m_locProjection, 1, GL_FALSE, projection);
+    glUniformMatrix4fv(m_locView, 1, GL_FALSE, view);
+    glUniform2f(m_locViewport, (float) viewportWidth, (float) viewportHeight);
+    glUniform2f(m_locLUTScale, scale, offset);
+    glUniform1f(m_locPointSize, pointSize);
+    glUniform1f(m_locSigma, sigma);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_1D, m_lut);
+
+    // overlapping PSFs add up; the bodies drawn before occlude through the depth test
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDepthMask(GL_FALSE);
+
+    glBindVertexArray(m_VAO);
+    glDrawArrays(GL_POINTS, 0, m_nStars);
+    glBindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+}
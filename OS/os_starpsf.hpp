@@ -0,0 +1,98 @@
+// OS_STARPSF.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: stars as sub-pixel Gaussian point spread functions: star
+//              photometry (magnitude to collected signal) through a
+//              lookup table, and a point-sprite pass that accumulates
+//              the pixel-integrated PSF of the whole field in one draw
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_STARPSF_HPP
+#define OS_STARPSF_HPP
+
+#include "include/glad/glad.h"
+
+#include <vector>
+
+// sensor and optics between a star of visual magnitude m and the pixels:
+// electrons = zeroPointFlux * 10^(-0.4 m) * aperture * exposure * efficiency,
+// a pixel value of 1 is fullWell electrons (defaults: a generic star tracker)
+struct StarPhotometry
+{
+    double zeroPointFlux;       // [photons/s/m^2] of a magnitude 0 star over the band (V: ~8.8e9)
+    double aperture;            // collecting area [m^2]
+    double exposure;            // integration time [s]
+    double efficiency;          // optics transmission x quantum efficiency
+    double fullWell;            // [e-]
+
+    StarPhotometry() : zeroPointFlux(8.8e9), aperture(1.7e-4), exposure(0.2), efficiency(0.5), fullWell(1.0e4) {};
+    double Electrons(double mag) const;
+};
+
+// total signal of a star (sum over its PSF, in pixel values) tabulated over magnitude
+class MagnitudeLUT
+{
+public:
+    static const int SIZE = 321;
+    static const float MAG_MIN;
+    static const float MAG_MAX;
+
+    MagnitudeLUT();
+    void Build(const StarPhotometry& photometry);
+
+    // linear between entries, clamped to the table range
+    float Signal(float mag) const;
+
+    std::vector<float> m_table;
+};
+
+// fraction of a unit-flux Gaussian PSF (sigma [pix]) collected by the pixel whose center is
+// (dx, dy) from the PSF center: the CPU twin of the splat fragment shader
+float PixelFraction(float dx, float dy, float sigma);
+
+// pixels around the PSF center that get any signal (+- radius)
+int PSFRadius(float sigma);
+
+class StarSplat
+{
+public:
+    StarSplat();
+
+    bool Create();
+    void Delete();
+
+    // signal per magnitude, sampled by the vertex shader (before the first Draw)
+    void SetLUT(const MagnitudeLUT& lut);
+
+    // N stars, 4 floats each: unit direction (GL frame, xyz) and visual magnitude
+    void Upload(const float* stars, int N);
+
+    // stars at infinity through projection * rotation(view), added onto the bound target
+    // (viewport in pixels) behind every body drawn so far; depth is tested, never written
+    void Draw(const float* projection, const float* view, int viewportWidth, int viewportHeight, float sigma);
+
+    bool m_initialized;
+
+private:
+    GLuint m_program;
+    GLuint m_VAO;
+    GLuint m_VBO;
+    GLuint m_lut;
+    int m_nStars;
+    int m_capacity;
+    float m_maxPointSize;
+
+    GLint m_locProjection;
+    GLint m_locView;
+    GLint m_locViewport;
+    GLint m_locLUTScale;
+    GLint m_locPointSize;
+    GLint m_locSigma;
+};
+
+#endif
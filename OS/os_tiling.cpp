@@ -0,0 +1,141 @@
+// OS_TILING.CPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: frames larger than the render target: tile layout over
+//              the image plane and assembly of the rendered tiles into a
+//              caller buffer or a file streamed one tile row at a time
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#include "os_tiling.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+TiledFrame::TiledFrame() :
+    m_width(0),
+    m_height(0),
+    m_channels(0),
+    m_tilesPerRow(0),
+    m_next(0),
+    m_file(NULL),
+    m_out(NULL),
+    m_ok(false)
+{
+}
+
+TiledFrame::~TiledFrame(){
+    if (m_file != NULL)
+        fclose(m_file);
+}
+
+void TiledFrame::Layout(int tileWidth, int tileHeight){
+
+    m_tiles.clear();
+    m_tilesPerRow = (m_width + tileWidth - 1) / tileWidth;
+    for (int top = m_height; top > 0; top -= tileHeight){
+        int bottom = std::max(0, top - tileHeight);
+        for (int left = 0; left < m_width; left += tileWidth){
+            Tile tile;
+            tile.x = left;
+            tile.y = bottom;
+            tile.width = std::min(tileWidth, m_width - left);
+            tile.height = top - bottom;
+            m_tiles.push_back(tile);
+        }
+    }
+    m_next = 0;
+    m_strip.assign((size_t) m_channels * m_width * std::min(tileHeight, m_height), 0);
+}
+
+bool TiledFrame::OpenFile(const std::string& filename, int width, int height, int channels, int tileWidth, int tileHeight){
+
+    Close();
+    if (width < 1 || height < 1 || tileWidth < 1 || tileHeight < 1 || (channels != 1 && channels != 3))
+        return false;
+
+    m_file = fopen(filename.c_str(), "wb");
+    if (m_file == NULL){
+        std::cout << "Cannot write tiled frame " << filename << std::endl;
+        return false;
+    }
+    fprintf(m_file, "P%d\n%d %d\n255\n", channels == 3 ? 6 : 5, width, height);
+
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_out = NULL;
+    m_ok = true;
+    Layout(tileWidth, tileHeight);
+    return true;
+}
+
+bool TiledFrame::OpenBuffer(unsigned char* out, int width, int height, int channels, int tileWidth, int tileHeight){
+
+    Close();
+    if (out == NULL || width < 1 || height < 1 || tileWidth < 1 || tileHeight < 1 || (channels != 1 && channels != 3))
+        return false;
+
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_out = out;
+    m_ok = true;
+    Layout(tileWidth, tileHeight);
+    return true;
+}
+
+bool TiledFrame::Put(int i, const unsigned char* pixels){
+
+    if (!m_ok || i != m_next || i >= (int) m_tiles.size())
+        return false;
+
+    // into the strip at the tile's column, row 0 = bottom row of the strip
+    const Tile& tile = m_tiles[i];
+    size_t tileRow = (size_t) m_channels * tile.width;
+    size_t stripRow = (size_t) m_channels * m_width;
+    for (int r = 0; r < tile.height; r++)
+        std::memcpy(&m_strip[r * stripRow + (size_t) m_channels * tile.x], pixels + r * tileRow, tileRow);
+
+    m_next++;
+    if (m_next % m_tilesPerRow == 0)
+        m_ok = FlushStrip();
+    return m_ok;
+}
+
+bool TiledFrame::FlushStrip(){
+
+    const Tile& first = m_tiles[m_next - m_tilesPerRow];
+    size_t stripRow = (size_t) m_channels * m_width;
+
+    // buffer: same bottom-up layout, one copy; file: rows top-down
+    if (m_out != NULL){
+        std::memcpy(m_out + first.y * stripRow, m_strip.data(), first.height * stripRow);
+        return true;
+    }
+    for (int r = first.height - 1; r >= 0; r--)
+        if (fwrite(&m_strip[r * stripRow], 1, stripRow, m_file) != stripRow)
+            return false;
+    return true;
+}
+
+bool TiledFrame::Close(){
+
+    bool complete = m_ok && m_next == (int) m_tiles.size();
+    if (m_file != NULL){
+        complete = (fclose(m_file) == 0) && complete;
+        m_file = NULL;
+    }
+    m_out = NULL;
+    m_ok = false;
+    m_tiles.clear();
+    m_strip.clear();
+    m_strip.shrink_to_fit();
+    m_next = 0;
+    return complete;
+}
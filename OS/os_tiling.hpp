@@ -0,0 +1,71 @@
+// OS_TILING.HPP
+// ------------------------------------------------------------------------
+// DESCRIPTION: frames larger than the render target: tile layout over
+//              the image plane and assembly of the rendered tiles into a
+//              caller buffer or a file streamed one tile row at a time
+// ------------------------------------------------------------------------
+// AUTHOR: SLAB Group
+//         2026-10-17  Created
+// ------------------------------------------------------------------------
+// COPYRIGHT: 2016 SLAB Group
+//            OS Function
+// ------------------------------------------------------------------------
+
+#ifndef OS_TILING_HPP
+#define OS_TILING_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// pixel rectangle of the full frame, origin bottom-left like GL window coordinates
+struct Tile
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// tiles are ordered top tile row first, left to right, so every completed row of
+// tiles (a strip) can leave memory at once: at most width * tileHeight pixels are held
+class TiledFrame
+{
+public:
+    TiledFrame();
+    ~TiledFrame();
+
+    // binary PPM (3 channels) / PGM (1 channel), rows top-down as written by the strips
+    bool OpenFile(const std::string& filename, int width, int height, int channels, int tileWidth, int tileHeight);
+
+    // caller buffer of width * height * channels bytes, bottom-up rows like the GL readback
+    bool OpenBuffer(unsigned char* out, int width, int height, int channels, int tileWidth, int tileHeight);
+
+    int Tiles() const                       { return (int) m_tiles.size(); };
+    const Tile& GetTile(int i) const        { return m_tiles[i]; };
+
+    // tile i as read back (tile.width * tile.height * channels bytes, bottom-up rows);
+    // tiles must arrive in order, false on an I/O error
+    bool Put(int i, const unsigned char* pixels);
+
+    // false if tiles are missing or the file could not be completed
+    bool Close();
+
+    int m_width;
+    int m_height;
+    int m_channels;
+
+private:
+    void Layout(int tileWidth, int tileHeight);
+    bool FlushStrip();
+
+    std::vector<Tile> m_tiles;
+    int m_tilesPerRow;
+    int m_next;                             // next tile expected by Put
+    std::vector<unsigned char> m_strip;     // current tile row, bottom-up
+    FILE* m_file;
+    unsigned char* m_out;
+    bool m_ok;
+};
+
+#endif
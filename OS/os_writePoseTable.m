@@ -0,0 +1,25 @@
+function os_writePoseTable(fn, r_Vo2To_vbs, q_vbs2tango, r_Vo2So_vbs)
+% OS_WRITEPOSETABLE  writes a pose table for os_farm (see os_posetable.hpp)
+%   fn:           output file, '.bin' for the binary format, CSV otherwise
+%   r_Vo2To_vbs:  N x 3 Tango positions [m]
+%   q_vbs2tango:  N x 4 Tango attitudes (scalar first)
+%   r_Vo2So_vbs:  N x 3 sun directions, or 1 x 3 for every frame
+
+N = size(r_Vo2To_vbs, 1);
+if size(r_Vo2So_vbs, 1) == 1
+    r_Vo2So_vbs = repmat(r_Vo2So_vbs, N, 1);
+end
+T = [r_Vo2To_vbs, q_vbs2tango, r_Vo2So_vbs];
+
+[~, ~, ext] = fileparts(fn);
+if strcmp(ext, '.bin')
+    fid = fopen(fn, 'w', 'ieee-le');
+    fwrite(fid, 'OSPT', 'char');
+    fwrite(fid, [1 size(T, 2)], 'uint32');
+    fwrite(fid, N, 'uint64');
+    fwrite(fid, T.', 'double');
+    fclose(fid);
+else
+    dlmwrite(fn, T, 'precision', 17);
+end
+end
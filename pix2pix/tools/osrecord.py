@@ -0,0 +1,117 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+# reader for the raw tensor shards written by the optical stimulator (OS/os_shardwriter.hpp):
+#   <prefix>-00000.tfrecord   tf.train.Example records, features "row", "<name>", "<name>/shape", "<name>/dtype"
+#   <prefix>-00000.index      tensor schema and per-record offsets, for memory-mapped access without TF
+#
+#   python osrecord.py --check shard-00000.tfrecord     verifies every record CRC against the index
+
+import argparse
+import mmap
+import struct
+
+TYPES = {1: ("uint8", 1), 2: ("uint16", 2), 3: ("float32", 4)}
+
+
+def read_index(index_path):
+    """returns (tensors, entries): tensors = [(name, dtype, shape, nbytes)],
+    entries = [(row, record_offset, record_length, [data_offset per tensor])]"""
+    with open(index_path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"OSRI":
+        raise Exception("not an OS shard index: " + index_path)
+    version, n_tensors = struct.unpack_from("<II", data, 4)
+    pos = 12
+    tensors = []
+    for _ in range(n_tensors):
+        (name_length,) = struct.unpack_from("<I", data, pos)
+        name = data[pos + 4:pos + 4 + name_length].decode("utf-8")
+        pos += 4 + name_length
+        type_id, rank = struct.unpack_from("<II", data, pos)
+        shape = list(struct.unpack_from("<%dq" % rank, data, pos + 8))
+        pos += 8 + 8 * rank
+        dtype, size = TYPES[type_id]
+        for d in shape:
+            size *= d
+        tensors.append((name, dtype, shape, size))
+
+    entry_size = 8 * (3 + n_tensors)
+    entries = []
+    while pos + entry_size <= len(data):
+        values = struct.unpack_from("<%dQ" % (3 + n_tensors), data, pos)
+        entries.append((values[0], values[1], values[2], list(values[3:])))
+        pos += entry_size
+    return tensors, entries
+
+
+class Shard(object):
+    """memory-mapped shard: shard[i] = {"row": row, name: array or bytes}"""
+
+    def __init__(self, tfrecord_path):
+        self.tensors, self.entries = read_index(tfrecord_path[:-len(".tfrecord")] + ".index")
+        self.file = open(tfrecord_path, "rb")
+        self.map = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+
+    def __len__(self):
+        return len(self.entries)
+
+    def __getitem__(self, i):
+        row, _, _, offsets = self.entries[i]
+        record = {"row": row}
+        for (name, dtype, shape, size), offset in zip(self.tensors, offsets):
+            try:
+                import numpy as np
+                record[name] = np.frombuffer(self.map, dtype=dtype, count=size // np.dtype(dtype).itemsize,
+                                             offset=offset).reshape(shape)
+            except ImportError:
+                record[name] = self.map[offset:offset + size]
+        return record
+
+
+def tf_parse(serialized, tensors):
+    """tf.data map function for TFRecordDataset over the shards; tensors from read_index"""
+    import tensorflow as tf
+    features = {"row": tf.FixedLenFeature([], tf.int64)}
+    for name, _, _, _ in tensors:
+        features[name] = tf.FixedLenFeature([], tf.string)
+    parsed = tf.parse_single_example(serialized, features)
+    out = {"row": parsed["row"]}
+    for name, dtype, shape, _ in tensors:
+        out[name] = tf.reshape(tf.decode_raw(parsed[name], getattr(tf, dtype)), shape)
+    return out
+
+
+def crc32c(data, crc=0):
+    crc ^= 0xFFFFFFFF
+    for b in bytearray(data):
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x82F63B78 if crc & 1 else crc >> 1
+    return crc ^ 0xFFFFFFFF
+
+
+def masked_crc(data):
+    crc = crc32c(data)
+    return (((crc >> 15) | (crc << 17)) + 0xA282EAD8) & 0xFFFFFFFF
+
+
+def check(tfrecord_path):
+    shard = Shard(tfrecord_path)
+    for row, offset, length, _ in shard.entries:
+        m = shard.map
+        (stored_length,) = struct.unpack_from("<Q", m, offset)
+        (length_crc,) = struct.unpack_from("<I", m, offset + 8)
+        data = m[offset + 12:offset + 12 + length]
+        (data_crc,) = struct.unpack_from("<I", m, offset + 12 + length)
+        ok = (stored_length == length and length_crc == masked_crc(m[offset:offset + 8]) and
+              data_crc == masked_crc(data))
+        print("row %d: %s" % (row, "ok" if ok else "CORRUPT"))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--check", type=str, required=True, help="shard (.tfrecord) to verify")
+    a = parser.parse_args()
+    check(a.check)